@@ -0,0 +1,242 @@
+#version 450 core
+
+layout (local_size_x = 64) in;
+
+#include "draw_data.glsl"
+
+struct DrawCommand {
+    uint count;
+    uint instance_count;
+    uint first_index;
+    int base_vertex;
+    uint base_instance;
+};
+
+layout (std430, binding = 1) writeonly buffer DrawCommandBuffer {
+    DrawCommand commands[];
+};
+
+layout (std430, binding = 2) writeonly buffer DrawIdBuffer {
+    uint draw_ids[];
+};
+
+layout (std430, binding = 3) buffer DrawCountBuffer {
+    uint counts[];
+};
+
+layout (std430, binding = 4) readonly buffer BatchOffsetBuffer {
+    uint batch_offsets[];
+};
+
+// Draw indices sorted by material.
+layout (std430, binding = 5) readonly buffer DrawOrderBuffer {
+    uint draw_order[];
+};
+
+// Matches SceneGeometry::MeshletData in src/SceneGeometry.h, stored once per mesh.
+struct MeshletData {
+    vec4 bounds;
+    vec4 cone;
+    uint index_count;
+    uint first_index;
+    uint lod;
+    uint padding;
+};
+
+layout (std430, binding = 6) readonly buffer MeshletBuffer {
+    MeshletData meshlets[];
+};
+
+// Matches SceneGeometry::MeshData in src/SceneGeometry.h.
+struct MeshData {
+    uint first_meshlets[MAX_LODS];
+    uint meshlet_counts[MAX_LODS];
+};
+
+layout (std430, binding = 8) readonly buffer MeshBuffer {
+    MeshData meshes[];
+};
+
+// The first command of every draw in the draw order when culling meshlets, followed by the total.
+// Every draw has room for the meshlets of its level of detail with the most.
+layout (std430, binding = 9) readonly buffer MeshletOffsetBuffer {
+    uint meshlet_offsets[];
+};
+
+// The number of draws. When culling meshlets, every work group culls those of one draw.
+uniform uint item_count;
+// Draws with higher indices are never visible.
+uniform uint active_draw_count;
+uniform bool cull_meshlets;
+uniform bool cone_culling;
+// xyz = camera position with w = 1, or view direction with w = 0.
+uniform vec4 viewer;
+// The projected size of one unit at a distance of 1, in multiples of the largest error allowed on
+// screen. 0 always selects the finest level of detail.
+uniform float lod_scale;
+uniform bool compact;
+uniform bool single_batch;
+uniform vec4 frustum_planes[6];
+
+uniform bool occlusion_culling;
+uniform mat4 previous_view_projection;
+uniform sampler2D depth_pyramid;
+uniform vec2 pyramid_size;
+uniform int pyramid_levels;
+
+bool is_in_frustum(vec3 center, float radius) {
+    for (int i = 0; i < 6; ++i) {
+        if (dot(frustum_planes[i].xyz, center) + frustum_planes[i].w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Mirrors SceneGeometry::select_lod.
+uint select_lod(DrawData draw, float scale) {
+    if (lod_scale == 0.0) {
+        return 0u;
+    }
+
+    float view_distance = 1.0;
+    if (viewer.w != 0.0) {
+        vec3 center = vec3(draw.model * vec4(draw.bounds.xyz, 1.0));
+        view_distance = distance(center, viewer.xyz) - draw.bounds.w * scale;
+        if (view_distance <= 0.0) {
+            return 0u;
+        }
+    }
+
+    uint lod = 0u;
+    while (lod + 1u < draw.lod_count &&
+           draw.lods[lod + 1u].error * scale * lod_scale <= view_distance) {
+        ++lod;
+    }
+    return lod;
+}
+
+// Whether every triangle within the normal cone faces away from the viewer.
+bool is_back_facing(vec3 center, float radius, vec3 axis, float cutoff) {
+    if (viewer.w == 0.0) {
+        return dot(viewer.xyz, axis) >= cutoff;
+    }
+    vec3 direction = center - viewer.xyz;
+    return dot(direction, axis) >= cutoff * length(direction) + radius;
+}
+
+bool is_occluded(vec3 center, float radius) {
+    vec2 uv_min = vec2(1.0);
+    vec2 uv_max = vec2(0.0);
+    float nearest_depth = 1.0;
+
+    for (int i = 0; i < 8; ++i) {
+        vec3 corner = center + radius * vec3(
+            (i & 1) != 0 ? 1.0 : -1.0,
+            (i & 2) != 0 ? 1.0 : -1.0,
+            (i & 4) != 0 ? 1.0 : -1.0
+        );
+        vec4 clip = previous_view_projection * vec4(corner, 1.0);
+        if (clip.w <= 0.0) {
+            // The bounds cross the camera plane of the previous frame.
+            return false;
+        }
+        vec3 ndc = clip.xyz / clip.w;
+        vec2 uv = ndc.xy * 0.5 + 0.5;
+        uv_min = min(uv_min, uv);
+        uv_max = max(uv_max, uv);
+        nearest_depth = min(nearest_depth, ndc.z * 0.5 + 0.5);
+    }
+
+    uv_min = clamp(uv_min, 0.0, 1.0);
+    uv_max = clamp(uv_max, 0.0, 1.0);
+
+    vec2 extent = (uv_max - uv_min) * pyramid_size;
+    float level = ceil(log2(max(max(extent.x, extent.y), 1.0)));
+    level = min(level, float(pyramid_levels - 1));
+
+    float depth = max(
+        max(textureLod(depth_pyramid, uv_min, level).r, textureLod(depth_pyramid, vec2(uv_max.x, uv_min.y), level).r),
+        max(textureLod(depth_pyramid, vec2(uv_min.x, uv_max.y), level).r, textureLod(depth_pyramid, uv_max, level).r)
+    );
+
+    return nearest_depth > depth;
+}
+
+bool is_visible(DrawData draw, float scale, vec4 bounds, vec4 cone) {
+    vec3 center = vec3(draw.model * vec4(bounds.xyz, 1.0));
+    float radius = bounds.w * scale;
+
+    if (!is_in_frustum(center, radius)) {
+        return false;
+    }
+    if (cone_culling && cone.w < 1.0 &&
+        is_back_facing(center, radius, normalize(mat3(draw.model) * cone.xyz), cone.w)) {
+        return false;
+    }
+    return !occlusion_culling || !is_occluded(center, radius);
+}
+
+// Without compaction, `slot` is the fixed command of the item and is also written when the item
+// is not visible.
+void emit(uint slot, bool visible, uint id, DrawData draw, uint index_count, uint first_index) {
+    if (compact) {
+        if (!visible) {
+            return;
+        }
+        uint batch = single_batch ? 0u : draw.material;
+        uint offset = single_batch ? 0u : batch_offsets[batch];
+        slot = offset + atomicAdd(counts[batch], 1u);
+    }
+
+    commands[slot].count = index_count;
+    commands[slot].instance_count = visible ? 1u : 0u;
+    commands[slot].first_index = first_index;
+    commands[slot].base_vertex = draw.base_vertex;
+    commands[slot].base_instance = slot;
+    draw_ids[slot] = id;
+}
+
+void main() {
+    // Work groups are laid out in two dimensions when there are too many for one.
+    uint group = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    uint position = cull_meshlets ? group : group * gl_WorkGroupSize.x + gl_LocalInvocationID.x;
+    if (position >= item_count) {
+        return;
+    }
+
+    uint id = draw_order[position];
+    DrawData draw = draws[id];
+    bool active = id < active_draw_count;
+    if (compact && !active) {
+        return;
+    }
+
+    mat3 model = mat3(draw.model);
+    float scale = max(max(length(model[0]), length(model[1])), length(model[2]));
+    // Selected for the whole draw, so that all of its meshlets agree.
+    uint lod = select_lod(draw, scale);
+
+    if (!cull_meshlets) {
+        bool visible = active && is_visible(draw, scale, draw.bounds, vec4(0.0, 0.0, 0.0, 1.0));
+        emit(position, visible, id, draw, draw.lods[lod].index_count, draw.lods[lod].first_index);
+        return;
+    }
+
+    // Only the meshlets of the selected level of detail are culled. Without compaction, the
+    // remaining commands of the draw are cleared.
+    MeshData mesh = meshes[draw.mesh];
+    uint first = mesh.first_meshlets[lod];
+    uint count = mesh.meshlet_counts[lod];
+    uint first_slot = meshlet_offsets[position];
+    uint slot_count = compact ? count : meshlet_offsets[position + 1u] - first_slot;
+    for (uint i = gl_LocalInvocationID.x; i < slot_count; i += gl_WorkGroupSize.x) {
+        if (i >= count) {
+            emit(first_slot + i, false, id, draw, 0u, 0u);
+            continue;
+        }
+        MeshletData meshlet = meshlets[first + i];
+        bool visible = active && is_visible(draw, scale, meshlet.bounds, meshlet.cone);
+        emit(first_slot + i, visible, id, draw, meshlet.index_count, meshlet.first_index);
+    }
+}
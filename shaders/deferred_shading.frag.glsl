@@ -1,32 +1,33 @@
-#version 330 core
-
-struct DirectionalLight {
-    vec3 direction;
-
-    vec3 color;
-    vec3 ambient;
-    float diffuse;
-    float specular;
-
-    mat4 transform;
-    sampler2D shadow_map;
-};
+#version 450 core
 
 in vec2 o_tex_coords;
 
-uniform DirectionalLight sun;
+#include "frame_data.glsl"
+#include "sun_data.glsl"
+#include "point_lights.glsl"
 
-uniform vec3 camera_position;
+uniform sampler2D shadow_map;
 
 uniform sampler2D albedo_map;
 uniform sampler2D positions_map;
 uniform sampler2D normals_map;
 
+// The shadow map is filtered with a (2 * PCF_RADIUS + 1)^2 kernel.
+#if defined(PCF_5X5)
+const int PCF_RADIUS = 2;
+#elif defined(PCF_3X3)
+const int PCF_RADIUS = 1;
+#else
+const int PCF_RADIUS = 0;
+#endif
+
 layout (location = 0) out vec4 frag_color;
+#ifdef BLOOM
 layout (location = 1) out vec4 bright_color;
+#endif
 
-float shadow(DirectionalLight light, vec4 position, vec3 normal) {
-    vec4 light_space_position = light.transform * position;
+float shadow(vec4 position, vec3 normal) {
+    vec4 light_space_position = sun.light_space * position;
     vec3 proj_coords = light_space_position.xyz / light_space_position.w;
     proj_coords = proj_coords * 0.5 + 0.5;
 
@@ -35,49 +36,75 @@ float shadow(DirectionalLight light, vec4 position, vec3 normal) {
     }
 
     float current_depth = proj_coords.z;
-    vec3 sun_dir = -light.direction;
+    vec3 sun_dir = -sun.direction;
     float bias = max(0.05 * (1.0 - dot(normal, sun_dir)), 0.005);
 
     float shadow = 0.0;
-    vec2 texel_size = 1.0 / textureSize(light.shadow_map, 0);
-    for (int x = -1; x <= 1; ++x) {
-        for (int y = -1; y <= 1; ++y) {
-            float pcf_depth = texture(light.shadow_map, proj_coords.xy + vec2(x, y) * texel_size).r;
+    vec2 texel_size = 1.0 / textureSize(shadow_map, 0);
+    for (int x = -PCF_RADIUS; x <= PCF_RADIUS; ++x) {
+        for (int y = -PCF_RADIUS; y <= PCF_RADIUS; ++y) {
+            float pcf_depth = texture(shadow_map, proj_coords.xy + vec2(x, y) * texel_size).r;
             shadow += (current_depth - bias > pcf_depth) ? 1.0 : 0.0;
         }
     }
 
-    return shadow / 9.0;
+    return shadow / float((2 * PCF_RADIUS + 1) * (2 * PCF_RADIUS + 1));
 }
 
-vec3 calc_directional_light(DirectionalLight light) {
-    vec3 diffuse_reflection = texture(albedo_map, o_tex_coords).rgb;
+vec3 calc_directional_light(vec4 position, vec3 normal, vec3 diffuse_reflection) {
     vec3 specular_reflection = vec3(0.0);
-    vec3 normal = texture(normals_map, o_tex_coords).xyz;
-    vec4 position = texture(positions_map, o_tex_coords);
 
-    vec3 ambient = diffuse_reflection * light.ambient;
+    vec3 ambient = diffuse_reflection * sun.ambient;
 
-    vec3 light_dir = normalize(-light.direction);
-    vec3 diffuse = max(dot(normal, light_dir), 0.0) * diffuse_reflection * light.diffuse * light.color;
+    vec3 light_dir = normalize(-sun.direction);
+    vec3 diffuse = max(dot(normal, light_dir), 0.0) * diffuse_reflection * sun.diffuse * sun.color;
 
-    vec3 camera_dir = normalize(camera_position - position.xyz);
+    vec3 camera_dir = normalize(frame.camera_position - position.xyz);
     vec3 half_dir = normalize(light_dir + camera_dir);
     float specular_strength = pow(max(dot(normal, half_dir), 0.0), 64.0);
-    vec3 specular = specular_strength * specular_reflection * light.specular * light.color;
+    vec3 specular = specular_strength * specular_reflection * sun.specular * sun.color;
+
+    return ambient + (1.0 - shadow(position, normal)) * (diffuse + specular);
+}
+
+// Every light is tested against every pixel, lights out of range are skipped.
+vec3 calc_point_lights(vec3 position, vec3 normal, vec3 diffuse_reflection) {
+    vec3 color = vec3(0.0);
+    for (uint i = 0u; i < point_light_count; ++i) {
+        PointLightData light = point_lights[i];
+        vec3 to_light = light.position - position;
+        float light_distance = length(to_light);
+        if (light_distance > light.radius) {
+            continue;
+        }
 
-    return ambient + (1.0 - shadow(light, position, normal)) * (diffuse + specular);
+        vec3 light_dir = to_light / light_distance;
+        float attenuation = 1.0 / (light.constant_attenuation +
+                                   light.linear_attenuation * light_distance +
+                                   light.quadratic_attenuation * light_distance * light_distance);
+        vec3 ambient = light.ambient * diffuse_reflection;
+        vec3 diffuse = max(dot(normal, light_dir), 0.0) * light.diffuse * diffuse_reflection;
+        color += (ambient + diffuse) * attenuation;
+    }
+    return color;
 }
 
 void main()
 {
-    vec3 color = calc_directional_light(sun);
+    vec3 diffuse_reflection = texture(albedo_map, o_tex_coords).rgb;
+    vec3 normal = texture(normals_map, o_tex_coords).xyz;
+    vec4 position = texture(positions_map, o_tex_coords);
+
+    vec3 color = calc_directional_light(position, normal, diffuse_reflection);
+    color += calc_point_lights(position.xyz, normal, diffuse_reflection);
     frag_color = vec4(color, 1.0);
 
+#ifdef BLOOM
     float brightness = dot(frag_color.rgb, vec3(0.2126, 0.7152, 0.0722));
     if (brightness > 1.0) {
         bright_color = frag_color;
     } else {
         bright_color = vec4(0.0, 0.0, 0.0, 1.0);
     }
+#endif
 }
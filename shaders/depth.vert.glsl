@@ -1,10 +1,27 @@
-#version 330 core
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+
+#include "draw_data.glsl"
 
 layout (location = 0) in vec3 a_position;
 
-uniform mat4 light_space;
-uniform mat4 model;
+#ifdef PACKED_VERTICES
+#include "packed_vertex.glsl"
+#endif
+
+// The draws of the instances of a command, starting at its base instance.
+layout (std430, binding = 2) readonly buffer DrawIdBuffer {
+    uint draw_ids[];
+};
+
+#include "sun_data.glsl"
 
 void main() {
-    gl_Position = light_space * model * vec4(a_position, 1.0);
+    DrawData draw = draws[draw_ids[gl_BaseInstanceARB + gl_InstanceID]];
+#ifdef PACKED_VERTICES
+    vec3 position = decode_position(a_position, draw.bounds);
+#else
+    vec3 position = a_position;
+#endif
+    gl_Position = sun.light_space * draw.model * vec4(position, 1.0);
 }
@@ -0,0 +1,32 @@
+#version 450 core
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+uniform sampler2D source;
+uniform int source_level;
+
+layout (r32f, binding = 0) uniform writeonly image2D destination;
+
+void main() {
+    ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 destination_size = imageSize(destination);
+    if (any(greaterThanEqual(position, destination_size))) {
+        return;
+    }
+
+    // Every texel keeps the farthest depth of the source texels it covers, which keeps the
+    // occlusion test conservative even when the source size is not a power of two.
+    ivec2 source_size = textureSize(source, source_level);
+    vec2 ratio = vec2(source_size) / vec2(destination_size);
+    ivec2 source_min = ivec2(floor(vec2(position) * ratio));
+    ivec2 source_max = min(ivec2(ceil(vec2(position + 1) * ratio)) - 1, source_size - 1);
+
+    float depth = 0.0;
+    for (int y = source_min.y; y <= source_max.y; ++y) {
+        for (int x = source_min.x; x <= source_max.x; ++x) {
+            depth = max(depth, texelFetch(source, ivec2(x, y), source_level).r);
+        }
+    }
+
+    imageStore(destination, position, vec4(depth));
+}
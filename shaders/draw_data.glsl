@@ -0,0 +1,25 @@
+// Matches SceneGeometry::DrawData in src/SceneGeometry.h.
+#define MAX_LODS 4
+
+struct Lod {
+    uint first_index;
+    uint index_count;
+    float error;
+    uint padding;
+};
+
+struct DrawData {
+    mat4 model;
+    vec4 bounds;
+    uint material;
+    int base_vertex;
+    uint lod_count;
+    // Shared by all instances of the same geometry.
+    uint mesh;
+    // Finest first.
+    Lod lods[MAX_LODS];
+};
+
+layout (std430, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
@@ -0,0 +1,6 @@
+// Matches FrameData in src/FrameData.h.
+layout (std140, binding = 0) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 camera_position;
+} frame;
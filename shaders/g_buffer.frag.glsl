@@ -6,10 +6,9 @@ struct Material {
 };
 
 in vec4 o_frag_position;
+in vec3 o_normal;
+in vec3 o_tangent;
 in vec2 o_tex_coords;
-in mat3 o_tbn;
-
-uniform vec3 camera_position;
 
 uniform Material material;
 
@@ -20,7 +19,10 @@ layout (location = 2) out vec3 frag_normal;
 vec3 get_normal() {
     vec3 normal = texture(material.normal_map, o_tex_coords).rgb;
     normal = normal * 2.0 - 1.0;
-    return normalize(o_tbn * normal);
+    vec3 n = normalize(o_normal);
+    vec3 t = normalize(o_tangent);
+    mat3 tbn = mat3(t, normalize(cross(n, t)), n);
+    return normalize(tbn * normal);
 }
 
 void main() {
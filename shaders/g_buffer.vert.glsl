@@ -1,27 +1,48 @@
-#version 330 core
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+
+#include "draw_data.glsl"
 
 layout (location = 0) in vec3 a_position;
-layout (location = 1) in vec3 a_normal;
 layout (location = 2) in vec2 a_tex_coords;
+#ifdef PACKED_VERTICES
+#include "packed_vertex.glsl"
+layout (location = 3) in vec4 a_tangent_frame;
+#else
+layout (location = 1) in vec3 a_normal;
 layout (location = 3) in vec3 a_tangent;
+#endif
+
+// The draws of the instances of a command, starting at its base instance.
+layout (std430, binding = 2) readonly buffer DrawIdBuffer {
+    uint draw_ids[];
+};
 
-uniform mat4 model;
-uniform mat4 projection;
-uniform mat4 view;
+#include "frame_data.glsl"
 
 out vec4 o_frag_position;
-out mat3 o_tbn;
+out vec3 o_normal;
+out vec3 o_tangent;
 out vec2 o_tex_coords;
 
 void main() {
-    o_frag_position = model * vec4(a_position, 1.0);
-    o_tex_coords = a_tex_coords;
+    DrawData draw = draws[draw_ids[gl_BaseInstanceARB + gl_InstanceID]];
+
+#ifdef PACKED_VERTICES
+    vec3 position = decode_position(a_position, draw.bounds);
+    vec3 normal;
+    vec3 tangent;
+    decode_tangent_frame(a_tangent_frame, normal, tangent);
+#else
+    vec3 position = a_position;
+    vec3 normal = a_normal;
+    vec3 tangent = a_tangent;
+#endif
 
-    vec3 bitangent = cross(a_normal, a_tangent);
-    vec3 t = normalize(vec3(model * vec4(a_tangent, 0.0)));
-    vec3 b = normalize(vec3(model * vec4(bitangent, 0.0)));
-    vec3 n = normalize(vec3(model * vec4(a_normal, 0.0)));
-    o_tbn = mat3(t, b, n);
+    o_frag_position = draw.model * vec4(position, 1.0);
+    o_tex_coords = a_tex_coords;
+    o_normal = vec3(draw.model * vec4(normal, 0.0));
+    o_tangent = vec3(draw.model * vec4(tangent, 0.0));
 
-    gl_Position = projection * view * o_frag_position;
+    gl_Position = frame.projection * frame.view * o_frag_position;
 }
@@ -0,0 +1,22 @@
+// Decoding of SceneGeometry::VertexFormat::Packed.
+
+// Positions are snorm16 relative to the bounding sphere (xyz = center, w = radius) of their draw.
+vec3 decode_position(vec3 position, vec4 bounds) {
+    return bounds.xyz + position * bounds.w;
+}
+
+// Returns the first (tangent) and last (normal) column of the rotation of a tangent frame
+// quaternion. The bitangent is cross(normal, tangent).
+void decode_tangent_frame(vec4 q, out vec3 normal, out vec3 tangent) {
+    q = normalize(q);
+    tangent = vec3(
+        1.0 - 2.0 * (q.y * q.y + q.z * q.z),
+        2.0 * (q.x * q.y + q.w * q.z),
+        2.0 * (q.x * q.z - q.w * q.y)
+    );
+    normal = vec3(
+        2.0 * (q.x * q.z + q.w * q.y),
+        2.0 * (q.y * q.z - q.w * q.x),
+        1.0 - 2.0 * (q.x * q.x + q.y * q.y)
+    );
+}
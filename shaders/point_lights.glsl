@@ -0,0 +1,17 @@
+// Matches PointLightData in src/PointLight.h.
+struct PointLightData {
+    vec3 position;
+    float radius;
+    vec3 ambient;
+    float constant_attenuation;
+    vec3 diffuse;
+    float linear_attenuation;
+    vec3 specular;
+    float quadratic_attenuation;
+};
+
+layout (std430, binding = 7) readonly buffer PointLightBuffer {
+    PointLightData point_lights[];
+};
+
+uniform uint point_light_count;
@@ -3,7 +3,9 @@
 in vec2 o_tex_coords;
 
 uniform sampler2D screen_texture;
+#ifdef BLOOM
 uniform sampler2D bloom_texture;
+#endif
 uniform float gamma;
 uniform float exposure;
 
@@ -28,8 +30,10 @@ vec3 tone_mapping(vec3 color) {
 
 void main() {
     vec3 color = texture(screen_texture, o_tex_coords).rgb;
+#ifdef BLOOM
     vec3 bloom = texture(bloom_texture, o_tex_coords).rgb;
     color += bloom;
+#endif
     //    color = grayscale(color);
     color = tone_mapping(color);
     color = gamma_correct(color);
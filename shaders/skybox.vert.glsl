@@ -1,15 +1,15 @@
-#version 330 core
+#version 450 core
 
 layout (location = 0) in vec3 a_position;
 
-uniform mat4 projection;
-uniform mat4 view;
+#include "frame_data.glsl"
 
 out vec3 o_tex_coords;
 
 void main()
 {
     o_tex_coords = a_position;
-    vec4 position = projection * view * vec4(a_position, 1.0);
+    mat4 view_no_translation = mat4(mat3(frame.view));
+    vec4 position = frame.projection * view_no_translation * vec4(a_position, 1.0);
     gl_Position = position.xyww;
 }
@@ -0,0 +1,9 @@
+// Matches SunData in src/FrameData.h.
+layout (std140, binding = 1) uniform SunData {
+    mat4 light_space;
+    vec3 direction;
+    float diffuse;
+    vec3 color;
+    float specular;
+    vec3 ambient;
+} sun;
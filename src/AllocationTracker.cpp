@@ -0,0 +1,196 @@
+#include "AllocationTracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <fmt/format.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+thread_local constinit FramePhase current_phase = FramePhase::Other;
+} // namespace
+
+AllocationTracker &AllocationTracker::get()
+{
+    // Constant initialized, so that operator new can use it before main and without a guard.
+    static constinit AllocationTracker tracker;
+    return tracker;
+}
+
+bool AllocationTracker::is_enabled()
+{
+#ifdef TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char *AllocationTracker::get_phase_name(const FramePhase phase)
+{
+    switch (phase)
+    {
+        case FramePhase::Update:
+            return "update";
+        case FramePhase::Shadow:
+            return "shadow";
+        case FramePhase::GeometryBuffer:
+            return "G-buffer";
+        case FramePhase::Lighting:
+            return "lighting";
+        case FramePhase::PostProcessing:
+            return "post-processing";
+        case FramePhase::UI:
+            return "UI";
+        case FramePhase::Other:
+            return "other";
+    }
+    return "unknown";
+}
+
+void AllocationTracker::set_phase(const FramePhase phase)
+{
+    current_phase = phase;
+}
+
+void AllocationTracker::record(const std::size_t bytes)
+{
+    auto &counter = m_current[static_cast<std::size_t>(current_phase)];
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+    counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocationTracker::end_frame()
+{
+    for (std::size_t i = 0; i < PHASE_COUNT; ++i)
+    {
+        m_last_frame[i] = Counter{
+            .allocations = m_current[i].allocations.exchange(0, std::memory_order_relaxed),
+            .bytes = m_current[i].bytes.exchange(0, std::memory_order_relaxed),
+        };
+    }
+    set_phase(FramePhase::Other);
+
+    if (m_settle_frames > 0)
+    {
+        --m_settle_frames;
+        return;
+    }
+    if (m_settle_frames < 0 || get_last_frame_total().allocations == 0)
+    {
+        return;
+    }
+
+    std::string phases;
+    for (std::size_t i = 0; i < PHASE_COUNT; ++i)
+    {
+        if (m_last_frame[i].allocations != 0)
+        {
+            phases += fmt::format(
+                "{}{}: {} ({} bytes)",
+                phases.empty() ? "" : ", ",
+                get_phase_name(static_cast<FramePhase>(i)),
+                m_last_frame[i].allocations,
+                m_last_frame[i].bytes
+            );
+        }
+    }
+    m_settle_frames = -1;
+    throw std::runtime_error(fmt::format("steady-state frame allocated memory: {}", phases));
+}
+
+void AllocationTracker::set_steady_state_check(const bool enabled)
+{
+    m_settle_frames = enabled ? SETTLE_FRAMES : -1;
+}
+
+void AllocationTracker::restart_settling()
+{
+    if (m_settle_frames >= 0)
+    {
+        m_settle_frames = SETTLE_FRAMES;
+    }
+}
+
+bool AllocationTracker::is_steady_state_check_enabled() const
+{
+    return m_settle_frames >= 0;
+}
+
+const AllocationTracker::Counter &AllocationTracker::get_last_frame(const FramePhase phase) const
+{
+    return m_last_frame[static_cast<std::size_t>(phase)];
+}
+
+AllocationTracker::Counter AllocationTracker::get_last_frame_total() const
+{
+    Counter total;
+    for (const auto &counter : m_last_frame)
+    {
+        total.allocations += counter.allocations;
+        total.bytes += counter.bytes;
+    }
+    return total;
+}
+
+#ifdef TRACK_ALLOCATIONS
+// The array and nothrow forms of operator new and delete call these by default.
+
+void *operator new(const std::size_t size)
+{
+    AllocationTracker::get().record(size);
+    if (auto *pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    AllocationTracker::get().record(size);
+    const auto align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    auto *pointer = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // aligned_alloc needs the size to be a non-zero multiple of the alignment.
+    auto *pointer = std::aligned_alloc(align, std::max((size + align - 1) / align * align, align));
+#endif
+    if (pointer)
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void operator delete(void *pointer, std::size_t, const std::align_val_t alignment) noexcept
+{
+    operator delete(pointer, alignment);
+}
+#endif
@@ -0,0 +1,80 @@
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// The parts of a frame that allocations are attributed to. Allocations of threads other than the
+// render thread, and of the render thread between frames, are counted as Other.
+enum class FramePhase : std::uint8_t
+{
+    Update,
+    Shadow,
+    GeometryBuffer,
+    Lighting,
+    PostProcessing,
+    UI,
+    Other,
+};
+
+// Counts the heap allocations made through the global operator new, per frame and phase. The
+// operators are only replaced in builds with TRACK_ALLOCATIONS defined, otherwise nothing is
+// counted. Meant to catch code that starts allocating in frames in which nothing changed.
+class AllocationTracker
+{
+  public:
+    static constexpr std::size_t PHASE_COUNT = 7;
+    // Frames after arming the steady-state check in which allocations are still allowed, e.g.
+    // for containers that grow to their final capacity.
+    static constexpr int SETTLE_FRAMES = 120;
+
+    struct Counter
+    {
+        std::uint64_t allocations{};
+        std::uint64_t bytes{};
+    };
+
+  private:
+    struct AtomicCounter
+    {
+        std::atomic<std::uint64_t> allocations;
+        std::atomic<std::uint64_t> bytes;
+    };
+
+    std::array<AtomicCounter, PHASE_COUNT> m_current{};
+    std::array<Counter, PHASE_COUNT> m_last_frame{};
+    // Frames until the steady-state check fails on allocations, -1 while it is not armed.
+    int m_settle_frames{-1};
+
+    constexpr AllocationTracker() = default;
+
+  public:
+    AllocationTracker(const AllocationTracker &) = delete;
+    const AllocationTracker &operator=(const AllocationTracker &) = delete;
+
+    static AllocationTracker &get();
+    [[nodiscard]] static bool is_enabled();
+    [[nodiscard]] static const char *get_phase_name(FramePhase phase);
+
+    // Sets the phase of the calling thread.
+    static void set_phase(FramePhase phase);
+    // Called by the replaced operator new.
+    void record(std::size_t bytes);
+
+    // Moves the counts since the previous call into the last frame's and returns the calling
+    // thread to Other. Throws if the steady-state check is armed, has settled and the frame
+    // allocated.
+    void end_frame();
+    void set_steady_state_check(bool enabled);
+    // Allows allocations for another SETTLE_FRAMES frames if the check is armed, e.g. after the
+    // scene has changed.
+    void restart_settling();
+    [[nodiscard]] bool is_steady_state_check_enabled() const;
+
+    [[nodiscard]] const Counter &get_last_frame(FramePhase phase) const;
+    [[nodiscard]] Counter get_last_frame_total() const;
+};
+
+#endif // ALLOCATION_TRACKER_H
@@ -1,7 +1,14 @@
 #include "App.h"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
 #include <stdexcept>
+#include <utility>
 
 #include <GLFW/glfw3.h>
 #include <assimp/postprocess.h>
@@ -14,12 +21,50 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
+#include "AllocationTracker.h"
+#include "GLObjectRegistry.h"
+#include "GLState.h"
+#include "MeshOptimizer.h"
+#include "ProgramBinaryCache.h"
+
 glm::vec3 assimp_to_glm(aiVector3D vec)
 {
     return {vec.x, vec.y, vec.z};
 }
 
-App::App(GLFWwindow *window) : m_window(window)
+glm::mat4 assimp_to_glm(const aiMatrix4x4 &matrix)
+{
+    // Assimp's matrices are row-major.
+    glm::mat4 result;
+    for (auto row = 0; row < 4; ++row)
+    {
+        for (auto column = 0; column < 4; ++column)
+        {
+            result[column][row] = matrix[row][column];
+        }
+    }
+    return result;
+}
+
+namespace
+{
+// Interleaves the bits of the coordinates, so that sorting by the code visits a grid in Z-order.
+std::uint32_t morton_code(const std::uint32_t x, const std::uint32_t y)
+{
+    std::uint32_t code = 0;
+    for (std::uint32_t bit = 0; bit < 16; ++bit)
+    {
+        code |= (x >> bit & 1u) << (2 * bit) | (y >> bit & 1u) << (2 * bit + 1);
+    }
+    return code;
+}
+} // namespace
+
+App::App(
+    GLFWwindow *window, const SceneGeometry::VertexFormat vertex_format,
+    const StressScene &stress_scene
+)
+    : m_window(window), m_stress_scene(stress_scene)
 {
     const auto *scene = m_assimp_importer.ReadFile(
         "./assets/sponza.gltf",
@@ -51,7 +96,7 @@ App::App(GLFWwindow *window) : m_window(window)
         }
 
         const auto diffuse_path = std::string("./assets/") + diffuse_name.C_Str();
-        const auto diffuse = Texture::from_file_2d(diffuse_path);
+        const auto diffuse = m_resources.load_texture(diffuse_path);
 
         if (material->GetTextureCount(aiTextureType_NORMALS) > 0)
         {
@@ -68,19 +113,21 @@ App::App(GLFWwindow *window) : m_window(window)
         }
 
         const auto normal_path = std::string("./assets/") + normal_name.C_Str();
-        const auto normal = Texture::from_file_2d(normal_path, false);
+        const auto normal = m_resources.load_texture(normal_path, false);
 
-        m_materials.push_back(std::make_shared<Material>(diffuse, normal));
+        const auto handle =
+            m_resources.add_material(Material{.m_diffuse = diffuse, .m_normal = normal});
+        m_materials.push_back(handle);
+        m_material_textures.push_back(m_resources.get_textures(handle));
     }
 
-    std::vector<Mesh> meshes;
-    meshes.reserve(scene->mRootNode->mNumMeshes);
-    for (auto i = 0; i < scene->mRootNode->mNumMeshes; ++i)
+    std::vector<MeshGeometry> meshes(scene->mNumMeshes);
+    for (auto i = 0; i < scene->mNumMeshes; ++i)
     {
-        const auto mesh_idx = scene->mRootNode->mMeshes[i];
-        const auto *mesh = scene->mMeshes[mesh_idx];
+        const auto *mesh = scene->mMeshes[i];
 
-        std::vector<Mesh::Vertex> vertices;
+        auto &vertices = meshes[i].vertices;
+        auto &indices = meshes[i].indices;
         vertices.reserve(mesh->mNumVertices);
         for (auto j = 0; j < mesh->mNumVertices; ++j)
         {
@@ -98,7 +145,6 @@ App::App(GLFWwindow *window) : m_window(window)
             vertices.emplace_back(vertex);
         }
 
-        std::vector<std::uint32_t> indices;
         for (auto j = 0; j < mesh->mNumFaces; ++j)
         {
             const auto face = mesh->mFaces[j];
@@ -107,23 +153,109 @@ App::App(GLFWwindow *window) : m_window(window)
                 indices.emplace_back(face.mIndices[k]);
             }
         }
+    }
+
+    // Copies of a mesh share its geometry, so only the first one is optimized and uploaded.
+    const auto instances = MeshOptimizer::find_instances(meshes);
+    std::vector<MeshGeometry> unique_meshes;
+    std::vector<std::size_t> unique_indices(meshes.size());
+    for (std::size_t i = 0; i < meshes.size(); ++i)
+    {
+        if (instances[i].mesh == i)
+        {
+            unique_indices[i] = unique_meshes.size();
+            unique_meshes.push_back(std::move(meshes[i]));
+        }
+    }
+    MeshOptimizer::optimize_all(unique_meshes, m_jobs);
+
+    // The node tree is added depth first, so that the model is a contiguous subtree. Every mesh
+    // of a node gets a leaf node of its own, which places a copy of another mesh relative to the
+    // original. The model transform replaces the root node's transformation, since the renderer's
+    // distances are in the units of the mesh data.
+    Model model{.m_root = m_scene_graph.get_node_count()};
+    std::vector<std::optional<GLuint>> mesh_draws(meshes.size());
+    std::vector<std::pair<const aiNode *, std::uint32_t>> nodes{
+        {scene->mRootNode, SceneGraph::NO_PARENT}
+    };
+    while (!nodes.empty())
+    {
+        const auto [node, parent] = nodes.back();
+        nodes.pop_back();
+        const auto index = m_scene_graph.add_node(
+            parent,
+            parent == SceneGraph::NO_PARENT ? model.m_transform.get_model_matrix()
+                                            : assimp_to_glm(node->mTransformation)
+        );
+        m_node_draws.resize(m_scene_graph.get_node_count(), NO_DRAW);
+
+        for (auto i = 0; i < node->mNumMeshes; ++i)
+        {
+            const auto mesh = node->mMeshes[i];
+            const auto &[original, offset] = instances[mesh];
+            const auto leaf =
+                m_scene_graph.add_node(index, glm::translate(glm::mat4(1.0f), offset));
+            const auto &matrix = m_scene_graph.get_world(leaf);
+            const auto material = scene->mMeshes[mesh]->mMaterialIndex;
+            auto &original_draw = mesh_draws[original];
+            const auto draw =
+                original_draw
+                    ? m_scene_geometry.add_instance(*original_draw, material, matrix)
+                    : m_scene_geometry.add_mesh(
+                          unique_meshes[unique_indices[original]],
+                          material,
+                          matrix
+                      );
+            if (!original_draw)
+            {
+                original_draw = draw;
+            }
+            m_node_draws.push_back(draw);
+            model.m_draws.push_back(draw);
+        }
 
-        const auto material = m_materials[mesh->mMaterialIndex];
+        for (auto i = node->mNumChildren; i > 0; --i)
+        {
+            nodes.emplace_back(node->mChildren[i - 1], index);
+        }
+    }
+    model.m_node_count = m_scene_graph.get_node_count() - model.m_root;
+    m_models.push_back(std::move(model));
+    build_stress_scene();
+
+    m_scene_geometry.upload(m_materials.size(), vertex_format);
+    upload_point_lights();
+    m_gpu_culling.emplace(m_scene_geometry, WINDOW_WIDTH, WINDOW_HEIGHT);
+    if (!m_gpu_culling->is_compacting())
+    {
+        spdlog::warn("glMultiDrawElementsIndirectCount is unavailable, culled draws will be "
+                     "submitted with an instance count of zero");
+    }
 
-        meshes.emplace_back(vertices, indices, material);
+    if (GLAD_GL_VERSION_4_6 || glfwExtensionSupported("GL_ARB_pipeline_statistics_query"))
+    {
+        m_geometry_queue.enable_fragment_statistics();
     }
-    m_models.emplace_back(meshes, Transform({0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}));
 
-    m_bloom_program.attach_shader(GL_VERTEX_SHADER, "./shaders/postprocessing.vert.glsl");
-    m_bloom_program.attach_shader(GL_FRAGMENT_SHADER, "./shaders/gaussian.frag.glsl");
-    m_bloom_program.link();
+    // Compile the variants used by the default settings up front, the others on first use.
+    m_bloom_variants.get(BLUR_HORIZONTAL);
+    m_bloom_variants.get(0);
+    m_deferred_shading_variants.get(get_deferred_shading_features());
+    m_post_processing_variants.get(get_post_processing_features());
 
     m_bloom_ping_pong_framebuffers[0].set_color_attachment(m_bloom_ping_pong_attachments[0]);
     m_bloom_ping_pong_framebuffers[1].set_color_attachment(m_bloom_ping_pong_attachments[1]);
 
+    if (vertex_format == SceneGeometry::VertexFormat::Packed)
+    {
+        m_depth_program.define("PACKED_VERTICES");
+        m_geometry_program.define("PACKED_VERTICES");
+    }
+
+    // No fragment shader, so that nothing but fixed-function depth writes runs per fragment.
     m_depth_program.attach_shader(GL_VERTEX_SHADER, "./shaders/depth.vert.glsl");
-    m_depth_program.attach_shader(GL_FRAGMENT_SHADER, "./shaders/depth.frag.glsl");
     m_depth_program.link();
+    m_depth_program.check_block("SunData", SUN_DATA_BINDING, sizeof(SunData));
 
     m_shadow_map_framebuffer.set_depth_attachment(m_shadow_map_depth_attachment);
     m_shadow_map_framebuffer.set_draw_buffer(GL_NONE);
@@ -132,6 +264,9 @@ App::App(GLFWwindow *window) : m_window(window)
     m_geometry_program.attach_shader(GL_VERTEX_SHADER, "./shaders/g_buffer.vert.glsl");
     m_geometry_program.attach_shader(GL_FRAGMENT_SHADER, "./shaders/g_buffer.frag.glsl");
     m_geometry_program.link();
+    m_geometry_program.check_block("FrameData", FRAME_DATA_BINDING, sizeof(FrameData));
+    m_geometry_uniforms.diffuse_map = m_geometry_program.get_uniform<int>("material.diffuse_map");
+    m_geometry_uniforms.normal_map = m_geometry_program.get_uniform<int>("material.normal_map");
 
     m_geometry_buffer.set_color_attachment(m_g_buffer_albedo, GL_COLOR_ATTACHMENT0);
     m_geometry_buffer.set_color_attachment(m_g_buffer_positions, GL_COLOR_ATTACHMENT1);
@@ -141,16 +276,6 @@ App::App(GLFWwindow *window) : m_window(window)
         std::array<GLenum, 3>{GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2}
     );
 
-    m_deferred_shading_program.attach_shader(
-        GL_VERTEX_SHADER,
-        "./shaders/deferred_shading.vert.glsl"
-    );
-    m_deferred_shading_program.attach_shader(
-        GL_FRAGMENT_SHADER,
-        "./shaders/deferred_shading.frag.glsl"
-    );
-    m_deferred_shading_program.link();
-
     m_post_processing_framebuffer.set_color_attachment(
         m_post_processing_color_attachment,
         GL_COLOR_ATTACHMENT0
@@ -167,20 +292,32 @@ App::App(GLFWwindow *window) : m_window(window)
     m_skybox_program.attach_shader(GL_VERTEX_SHADER, "./shaders/skybox.vert.glsl");
     m_skybox_program.attach_shader(GL_FRAGMENT_SHADER, "./shaders/skybox.frag.glsl");
     m_skybox_program.link();
+    m_skybox_program.check_block("FrameData", FRAME_DATA_BINDING, sizeof(FrameData));
+    m_skybox_uniforms.cubemap = m_skybox_program.get_uniform<int>("cubemap");
 
-    m_post_processing_program.attach_shader(GL_VERTEX_SHADER, "./shaders/postprocessing.vert.glsl");
-    m_post_processing_program.attach_shader(
-        GL_FRAGMENT_SHADER,
-        "./shaders/postprocessing.frag.glsl"
-    );
-    m_post_processing_program.link();
+    for (auto *program : {&m_depth_program, &m_geometry_program, &m_skybox_program})
+    {
+        m_shader_watcher.watch(*program);
+    }
+    for (auto *program : m_gpu_culling->get_programs())
+    {
+        m_shader_watcher.watch(*program);
+    }
+
+    ProgramBinaryCache::get().log_summary();
+
+    m_active_models = static_cast<int>(m_models.size());
+    if (m_stress_scene.benchmark)
+    {
+        m_scaling_benchmark.start(static_cast<int>(m_models.size()));
+    }
 }
 
 int App::run()
 {
     int width, height;
     glfwGetWindowSize(m_window, &width, &height);
-    glViewport(0, 0, width, height);
+    GLState::get().viewport(0, 0, width, height);
 
     glfwSetWindowUserPointer(m_window, this);
     glfwSetFramebufferSizeCallback(m_window, framebuffer_size_callback);
@@ -217,6 +354,7 @@ int App::run()
         const auto delta_time = now - last_frame_time;
         m_camera_controller.update(m_window, delta_time, m_camera);
 
+        m_shader_watcher.update();
         render(delta_time);
 
         last_frame_time = now;
@@ -226,103 +364,572 @@ int App::run()
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 
-    glfwTerminate();
     return EXIT_SUCCESS;
 }
 
+void App::build_stress_scene()
+{
+    const auto source = m_models.front();
+    const auto instance_count = m_stress_scene.columns * m_stress_scene.rows;
+    if (instance_count <= 1 && m_stress_scene.point_lights == 0)
+    {
+        return;
+    }
+
+    // The bounds of the model, from the bounding spheres of its draws, and the materials of the
+    // draws, read before adding draws moves them.
+    auto min = glm::vec3(std::numeric_limits<float>::max());
+    auto max = glm::vec3(std::numeric_limits<float>::lowest());
+    std::vector<GLuint> materials;
+    materials.reserve(source.m_draws.size());
+    for (const auto draw : source.m_draws)
+    {
+        const auto &data = m_scene_geometry.get_draws()[draw];
+        const auto center = glm::vec3(data.model * glm::vec4(glm::vec3(data.bounds), 1.0f));
+        min = glm::min(min, center - glm::vec3(data.bounds.w));
+        max = glm::max(max, center + glm::vec3(data.bounds.w));
+        materials.push_back(data.material);
+    }
+    const auto extent = max - min;
+    const auto cell_size = std::max(extent.x, extent.z) * STRESS_GRID_SPACING;
+
+    std::vector<glm::uvec2> cells;
+    cells.reserve(instance_count);
+    for (auto row = 0; row < m_stress_scene.rows; ++row)
+    {
+        for (auto column = 0; column < m_stress_scene.columns; ++column)
+        {
+            cells.emplace_back(column, row);
+        }
+    }
+    std::ranges::sort(cells, {}, [](const glm::uvec2 &cell) {
+        return morton_code(cell.x, cell.y);
+    });
+
+    std::mt19937 random(m_stress_scene.seed);
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+    // The first cell is the loaded model itself.
+    for (std::size_t i = 1; i < cells.size(); ++i)
+    {
+        auto position = glm::vec3(cells[i].x, 0.0f, cells[i].y) * cell_size;
+        Transform transform;
+        if (m_stress_scene.randomize)
+        {
+            position += glm::vec3(jitter(random), 0.0f, jitter(random)) * cell_size * 0.05f;
+            transform.m_rotation.y = jitter(random) * 15.0f;
+            transform.m_scale = glm::vec3(1.0f + jitter(random) * 0.1f);
+        }
+        // The transform translates before it rotates and scales.
+        transform.m_position =
+            glm::vec3(glm::inverse(transform.get_model_matrix()) * glm::vec4(position, 1.0f));
+
+        // A copy of the model's subtree, with the same draws in the same order.
+        Model model{
+            .m_root = m_scene_graph.get_node_count(),
+            .m_node_count = source.m_node_count,
+            .m_transform = transform,
+        };
+        model.m_draws.reserve(source.m_draws.size());
+        for (auto node = source.m_root; node < source.m_root + source.m_node_count; ++node)
+        {
+            const auto is_root = node == source.m_root;
+            const auto parent = is_root ? SceneGraph::NO_PARENT
+                                        : m_scene_graph.get_parent(node) - source.m_root +
+                                              model.m_root;
+            const auto copy = m_scene_graph.add_node(
+                parent,
+                is_root ? transform.get_model_matrix() : m_scene_graph.get_local(node)
+            );
+            auto draw = m_node_draws[node];
+            if (draw != NO_DRAW)
+            {
+                draw = m_scene_geometry.add_instance(
+                    draw,
+                    materials[model.m_draws.size()],
+                    m_scene_graph.get_world(copy)
+                );
+                model.m_draws.push_back(draw);
+            }
+            m_node_draws.push_back(draw);
+        }
+        m_models.push_back(std::move(model));
+    }
+
+    const auto grid_max =
+        max + glm::vec3(m_stress_scene.columns - 1, 0.0f, m_stress_scene.rows - 1) * cell_size;
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    m_point_lights.reserve(m_stress_scene.point_lights);
+    for (auto i = 0; i < m_stress_scene.point_lights; ++i)
+    {
+        const auto position = glm::vec3(unit(random), unit(random), unit(random));
+        const auto color = glm::vec3(unit(random), unit(random), unit(random));
+        m_point_lights.push_back(PointLight{
+            .m_position = min + (grid_max - min) * position,
+            .m_ambient = glm::vec3(0.0f),
+            .m_diffuse = color / std::max({color.x, color.y, color.z, 0.01f}),
+            .m_specular = glm::vec3(0.0f),
+            .m_constant_attenuation = 1.0f,
+            .m_linear_attenuation = 4.5f / STRESS_LIGHT_RANGE,
+            .m_quadratic_attenuation = 75.0f / (STRESS_LIGHT_RANGE * STRESS_LIGHT_RANGE),
+        });
+    }
+
+    spdlog::info(
+        "stress scene: {} x {} instances with {} draws, {} point lights",
+        m_stress_scene.columns,
+        m_stress_scene.rows,
+        m_scene_geometry.get_draw_count(),
+        m_point_lights.size()
+    );
+}
+
+void App::upload_point_lights()
+{
+    std::vector<PointLightData> lights;
+    lights.reserve(m_point_lights.size());
+    for (const auto &light : m_point_lights)
+    {
+        lights.push_back(PointLightData{
+            .position = light.m_position,
+            .radius = light.get_radius(),
+            .ambient = light.m_ambient,
+            .constant_attenuation = light.m_constant_attenuation,
+            .diffuse = light.m_diffuse,
+            .linear_attenuation = light.m_linear_attenuation,
+            .specular = light.m_specular,
+            .quadratic_attenuation = light.m_quadratic_attenuation,
+        });
+    }
+    // Storage buffers cannot be empty.
+    m_point_light_buffer.emplace(
+        static_cast<GLsizeiptr>(std::max<std::size_t>(lights.size(), 1) * sizeof(PointLightData)),
+        lights.empty() ? nullptr : lights.data(),
+        0
+    );
+}
+
+int App::get_active_model_count() const
+{
+    const auto count = m_scaling_benchmark.is_running() ? m_scaling_benchmark.get_instance_count()
+                                                        : m_active_models;
+    return std::clamp(count, 1, static_cast<int>(m_models.size()));
+}
+
+void App::update_draw_lists()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // Instances are added in order, so the active models own the first draws.
+    const auto active_models = std::span(m_models).first(get_active_model_count());
+    m_scene_geometry.set_active_draw_count(
+        static_cast<GLuint>(active_models.size() * m_models.front().m_draws.size())
+    );
+    m_uploaded_draws = m_scene_geometry.flush(m_ring_buffer);
+    const auto scene_version = m_scene_geometry.get_version();
+
+    if (!m_gpu_driven)
+    {
+        const auto shadow_lod_scale = get_shadow_lod_scale();
+        if (shadow_lod_scale != m_shadow_list_lod_scale)
+        {
+            m_shadow_queue.invalidate();
+        }
+        m_shadow_queue.set_instancing(m_instancing);
+
+        // The front-to-back order and the levels of detail only have to be roughly right, so
+        // they are refreshed when the camera has moved or turned noticeably instead of every
+        // frame.
+        const auto forward = m_camera.get_forward();
+        const auto camera_lod_scale = get_camera_lod_scale();
+        if (glm::distance(m_camera.m_eye, m_draw_list_eye) > DRAW_LIST_RESORT_DISTANCE ||
+            glm::dot(forward, m_draw_list_forward) < DRAW_LIST_RESORT_COSINE ||
+            camera_lod_scale != m_geometry_list_lod_scale)
+        {
+            m_geometry_queue.invalidate();
+        }
+        m_geometry_queue.set_sorting(m_sort_draws);
+        m_geometry_queue.set_instancing(m_instancing);
+
+        const auto rebuild_shadow = m_shadow_queue.needs_rebuild(scene_version);
+        const auto rebuild_geometry = m_geometry_queue.needs_rebuild(scene_version);
+        if (rebuild_shadow || rebuild_geometry)
+        {
+            // The levels of detail of both views are selected for all draws in parallel first.
+            const auto draw_count = m_scene_geometry.get_active_draw_count();
+            m_shadow_draw_lods.resize(draw_count);
+            m_camera_draw_lods.resize(draw_count);
+            const auto sun = glm::vec4(m_sun.get_direction(), 0.0f);
+            const auto eye = glm::vec4(m_camera.m_eye, 1.0f);
+            m_jobs.parallel_for(
+                draw_count,
+                LOD_SELECTION_GRAIN,
+                [&](const std::uint32_t begin, const std::uint32_t end) {
+                    for (auto draw = begin; draw < end; ++draw)
+                    {
+                        if (rebuild_shadow)
+                        {
+                            m_shadow_draw_lods[draw] =
+                                m_scene_geometry.select_lod(draw, sun, shadow_lod_scale);
+                        }
+                        if (rebuild_geometry)
+                        {
+                            m_camera_draw_lods[draw] =
+                                m_scene_geometry.select_lod(draw, eye, camera_lod_scale);
+                        }
+                    }
+                }
+            );
+
+            // Then the queues of the two views are recorded and sorted side by side, and only
+            // their upload is left to this thread.
+            auto record_shadow_queue = [&] {
+                m_shadow_queue.begin(RenderQueue::Pass::Shadow);
+                for (const auto &model : active_models)
+                {
+                    for (const auto draw : model.m_draws)
+                    {
+                        m_shadow_queue.push(m_depth_program, draw, m_shadow_draw_lods[draw]);
+                    }
+                }
+                m_shadow_queue.build();
+            };
+            JobSystem::Counter shadow_recorded;
+            if (rebuild_shadow)
+            {
+                m_jobs.run(shadow_recorded, record_shadow_queue);
+            }
+            if (rebuild_geometry)
+            {
+                m_geometry_queue.begin(
+                    RenderQueue::Pass::Geometry,
+                    m_camera.get_view_matrix(),
+                    m_camera.m_z_far
+                );
+                for (const auto &model : active_models)
+                {
+                    for (const auto draw : model.m_draws)
+                    {
+                        m_geometry_queue.push(m_geometry_program, draw, m_camera_draw_lods[draw]);
+                    }
+                }
+                m_geometry_queue.build();
+            }
+            m_jobs.wait(shadow_recorded);
+
+            if (rebuild_shadow)
+            {
+                m_shadow_queue.upload(scene_version, m_ring_buffer);
+                m_shadow_list_lod_scale = shadow_lod_scale;
+            }
+            if (rebuild_geometry)
+            {
+                m_geometry_queue.upload(scene_version, m_ring_buffer);
+                m_draw_list_eye = m_camera.m_eye;
+                m_draw_list_forward = forward;
+                m_geometry_list_lod_scale = camera_lod_scale;
+            }
+        }
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    m_draw_list_update_time = std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+void App::record_command_lists()
+{
+    // The lists of the previous frame live in an arena that is about to be reused.
+    m_shadow_commands.reset();
+    m_geometry_commands.reset();
+    if (m_gpu_driven)
+    {
+        return;
+    }
+
+    m_shadow_queue.read_fragment_statistics();
+    m_geometry_queue.read_fragment_statistics();
+
+    auto record_shadow_pass = [this] {
+        auto &commands =
+            m_shadow_commands.emplace(&m_frame_arenas.get(JobSystem::get_thread_index()));
+        m_shadow_queue.record(commands);
+    };
+    auto record_geometry_pass = [this] {
+        auto &commands =
+            m_geometry_commands.emplace(&m_frame_arenas.get(JobSystem::get_thread_index()));
+        commands.set_uniform(m_geometry_program, m_geometry_uniforms.diffuse_map, 0);
+        commands.set_uniform(m_geometry_program, m_geometry_uniforms.normal_map, 1);
+        m_geometry_queue.record(commands, m_material_textures);
+    };
+    JobSystem::Counter recorded;
+    m_jobs.run(recorded, record_shadow_pass);
+    m_jobs.run(recorded, record_geometry_pass);
+    m_jobs.wait(recorded);
+}
+
+void App::set_model_transform(Model &model, const Transform &transform)
+{
+    model.m_transform = transform;
+    m_scene_graph.set_local(model.m_root, transform.get_model_matrix());
+}
+
+void App::update_transforms()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto updated = m_scene_graph.update(m_jobs);
+    for (const auto node : updated)
+    {
+        if (const auto draw = m_node_draws[node]; draw != NO_DRAW)
+        {
+            m_scene_geometry.set_model_matrix(draw, m_scene_graph.get_world(node));
+        }
+    }
+    m_updated_nodes = updated.size();
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    m_transform_update_time = std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+void App::update_uniform_blocks()
+{
+    const FrameData frame{
+        .view = m_camera.get_view_matrix(),
+        .projection = m_camera.get_projection_matrix(),
+        .camera_position = m_camera.m_eye,
+    };
+    m_ring_buffer.push_uniform(FRAME_DATA_BINDING, &frame, sizeof(frame));
+
+    const SunData sun{
+        .light_space = m_sun.get_light_space_matrix(),
+        .direction = m_sun.get_direction(),
+        .diffuse = m_sun.m_diffuse,
+        .color = m_sun.m_color,
+        .specular = m_sun.m_specular,
+        .ambient = m_sun.m_ambient,
+    };
+    m_ring_buffer.push_uniform(SUN_DATA_BINDING, &sun, sizeof(sun));
+}
+
+ShaderFeatures App::get_deferred_shading_features() const
+{
+    ShaderFeatures features = 0;
+    if (m_pcf_radius == 1)
+    {
+        features |= SHADING_PCF_3X3;
+    }
+    else if (m_pcf_radius == 2)
+    {
+        features |= SHADING_PCF_5X5;
+    }
+    if (m_bloom && m_bloom_amount > 0)
+    {
+        features |= SHADING_BLOOM;
+    }
+    return features;
+}
+
+ShaderFeatures App::get_post_processing_features() const
+{
+    return m_bloom && m_bloom_amount > 0 ? POST_PROCESSING_BLOOM : 0;
+}
+
+float App::get_camera_lod_scale() const
+{
+    if (m_lod_benchmark.is_running() ? !m_lod_benchmark.uses_lods() : !m_lods)
+    {
+        return 0.0f;
+    }
+    const auto pixels_per_unit =
+        m_camera.get_projection_matrix()[1][1] * static_cast<float>(WINDOW_HEIGHT) * 0.5f;
+    return pixels_per_unit / m_lod_threshold;
+}
+
+float App::get_shadow_lod_scale() const
+{
+    if (m_lod_benchmark.is_running() ? !m_lod_benchmark.uses_lods() : !m_lods)
+    {
+        return 0.0f;
+    }
+    const auto texels_per_unit = static_cast<float>(SHADOW_MAP_SIZE) * 0.5f / m_sun.m_top_bottom;
+    return texels_per_unit / m_shadow_lod_threshold;
+}
+
 void App::render(const double delta_time)
 {
+    m_ring_buffer.begin_frame();
+    m_resources.begin_frame();
+    m_frame_arenas.begin_frame();
+    AllocationTracker::set_phase(FramePhase::Update);
+    if (m_thread_scaling_benchmark.is_running())
+    {
+        // Every frame of the benchmark updates all transforms and records both draw lists.
+        m_jobs.set_thread_limit(m_thread_scaling_benchmark.get_thread_count());
+        for (const auto &model : m_models)
+        {
+            m_scene_graph.set_local(model.m_root, m_scene_graph.get_local(model.m_root));
+        }
+        m_shadow_queue.invalidate();
+        m_geometry_queue.invalidate();
+    }
+    update_transforms();
+    update_draw_lists();
+    record_command_lists();
+    if (m_thread_scaling_benchmark.is_running())
+    {
+        m_thread_scaling_benchmark.record(
+            (m_transform_update_time + m_draw_list_update_time) / 1000.0
+        );
+        if (!m_thread_scaling_benchmark.is_running())
+        {
+            m_jobs.set_thread_limit(m_jobs.get_thread_count());
+        }
+    }
+    update_uniform_blocks();
+
+    AllocationTracker::set_phase(FramePhase::Shadow);
     glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "Shadow Map Render Pass");
-    glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+    m_shadow_timer.begin();
+    m_shadow_primitives.begin();
+    auto &gl_state = GLState::get();
+    gl_state.viewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
     m_shadow_map_framebuffer.bind();
     {
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
+        gl_state.enable(GL_DEPTH_TEST);
+        gl_state.enable(GL_CULL_FACE);
 
-        glClearColor(0.2, 0.0, 0.0, 1.0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glClear(GL_DEPTH_BUFFER_BIT);
 
-        m_depth_program.use();
-        m_depth_program.set_uniform("light_space", m_sun.get_light_space_matrix());
+        const auto light_space = m_sun.get_light_space_matrix();
+        if (m_gpu_driven)
+        {
+            m_gpu_culling->set_meshlet_culling(m_meshlet_culling);
+            m_gpu_culling->set_cone_culling(m_cone_culling);
+            m_gpu_culling->cull(
+                GpuCulling::View::Shadow,
+                light_space,
+                glm::vec4(m_sun.get_direction(), 0.0f),
+                get_shadow_lod_scale(),
+                false
+            );
+        }
 
-        for (const auto &model : m_models)
+        if (m_gpu_driven)
+        {
+            m_depth_program.use();
+            m_gpu_culling->draw(GpuCulling::View::Shadow, m_material_textures);
+        }
+        else
         {
-            model.draw(m_depth_program);
+            m_shadow_commands->replay();
         }
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl_state.bind_framebuffer(0);
+    m_shadow_primitives.end();
+    m_shadow_timer.end();
     glPopDebugGroup();
 
+    const auto camera_view_projection =
+        m_camera.get_projection_matrix() * m_camera.get_view_matrix();
+
+    AllocationTracker::set_phase(FramePhase::GeometryBuffer);
     glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "Geometry Buffer Render Pass");
-    glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    gl_state.viewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
     m_geometry_buffer.bind();
     {
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
+        gl_state.enable(GL_DEPTH_TEST);
+        gl_state.enable(GL_CULL_FACE);
 
         glClear(GL_DEPTH_BUFFER_BIT);
 
-        m_geometry_program.use();
-        m_geometry_program.set_uniform("view", m_camera.get_view_matrix());
-        m_geometry_program.set_uniform("projection", m_camera.get_projection_matrix());
-        m_geometry_program.set_uniform("camera_position", m_camera.m_eye);
-
-        m_geometry_program.set_uniform("material.diffuse_map", 0);
-        m_geometry_program.set_uniform("material.normal_map", 1);
+        if (m_gpu_driven)
+        {
+            m_gpu_culling->cull(
+                GpuCulling::View::Camera,
+                camera_view_projection,
+                glm::vec4(m_camera.m_eye, 1.0f),
+                get_camera_lod_scale(),
+                m_occlusion_culling
+            );
+        }
 
-        for (const auto &model : m_models)
+        m_geometry_timer.begin();
+        m_geometry_primitives.begin();
+        if (m_gpu_driven)
+        {
+            m_geometry_program.use();
+            m_geometry_program.set_uniform(m_geometry_uniforms.diffuse_map, 0);
+            m_geometry_program.set_uniform(m_geometry_uniforms.normal_map, 1);
+            m_gpu_culling->draw(GpuCulling::View::Camera, m_material_textures);
+        }
+        else
         {
-            model.draw(m_geometry_program);
+            m_geometry_commands->replay();
         }
+        m_geometry_primitives.end();
+        m_geometry_timer.end();
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl_state.bind_framebuffer(0);
     glPopDebugGroup();
 
+    if (m_gpu_driven)
+    {
+        glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "Depth Pyramid Pass");
+        m_gpu_culling->build_depth_pyramid(m_g_buffer_depth, camera_view_projection);
+        glPopDebugGroup();
+    }
+    else
+    {
+        m_gpu_culling->invalidate_depth_pyramid();
+    }
+
+    AllocationTracker::set_phase(FramePhase::Lighting);
     glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "Deferred Shading Render Pass");
+    m_shading_timer.begin();
     m_post_processing_framebuffer.bind();
     {
-        glDepthMask(GL_FALSE);
-        m_deferred_shading_program.use();
-        m_deferred_shading_program.set_uniform("camera_position", m_camera.m_eye);
-        m_deferred_shading_program.set_uniform("sun.direction", m_sun.get_direction());
-        m_deferred_shading_program.set_uniform("sun.color", m_sun.m_color);
-        m_deferred_shading_program.set_uniform("sun.ambient", m_sun.m_ambient);
-        m_deferred_shading_program.set_uniform("sun.diffuse", m_sun.m_diffuse);
-        m_deferred_shading_program.set_uniform("sun.specular", m_sun.m_specular);
-        m_deferred_shading_program.set_uniform("sun.shadow_map", 0);
-        m_deferred_shading_program.set_uniform("sun.transform", m_sun.get_light_space_matrix());
-        m_deferred_shading_program.set_uniform("albedo_map", 1);
-        m_deferred_shading_program.set_uniform("positions_map", 2);
-        m_deferred_shading_program.set_uniform("normals_map", 3);
+        gl_state.depth_mask(GL_FALSE);
+        auto &[deferred_program, deferred] =
+            m_deferred_shading_variants.get(get_deferred_shading_features());
+        deferred_program.use();
+        deferred_program.set_uniform(deferred.shadow_map, 0);
+        deferred_program.set_uniform(deferred.albedo_map, 1);
+        deferred_program.set_uniform(deferred.positions_map, 2);
+        deferred_program.set_uniform(deferred.normals_map, 3);
+        deferred_program.set_uniform(
+            deferred.point_light_count,
+            static_cast<GLuint>(m_point_lights.size())
+        );
         m_shadow_map_depth_attachment.bind(GL_TEXTURE0);
         m_g_buffer_albedo.bind(GL_TEXTURE1);
         m_g_buffer_positions.bind(GL_TEXTURE2);
         m_g_buffer_normals.bind(GL_TEXTURE3);
+        m_point_light_buffer->bind_base(GL_SHADER_STORAGE_BUFFER, POINT_LIGHT_BINDING);
         m_post_processing_plane.draw();
+        m_shading_timer.end();
 
-        glDepthMask(GL_TRUE);
-        const auto camera_view = m_camera.get_view_matrix();
-        const auto camera_view_no_translation = glm::mat4(glm::mat3(camera_view));
-        glDepthFunc(GL_LEQUAL);
+        gl_state.depth_mask(GL_TRUE);
+        gl_state.depth_func(GL_LEQUAL);
         m_skybox_program.use();
-        m_skybox_program.set_uniform("view", camera_view_no_translation);
-        m_skybox_program.set_uniform("projection", m_camera.get_projection_matrix());
-        m_skybox_texture->bind(GL_TEXTURE0);
+        m_skybox_program.set_uniform(m_skybox_uniforms.cubemap, 0);
+        m_resources.get(m_skybox_texture).bind(GL_TEXTURE0);
         m_skybox_mesh.draw();
-        glDepthFunc(GL_LESS);
+        gl_state.depth_func(GL_LESS);
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl_state.bind_framebuffer(0);
     glPopDebugGroup();
 
-    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "Bloom Ping-Pong Render Pass");
+    AllocationTracker::set_phase(FramePhase::PostProcessing);
+    if (m_bloom && m_bloom_amount > 0)
     {
+        glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "Bloom Ping-Pong Render Pass");
         auto horizontal = true;
         auto first_iteration = true;
-        m_bloom_program.use();
         for (auto i = 0; i < 2 * m_bloom_amount; ++i)
         {
+            auto &[bloom_program, bloom] = m_bloom_variants.get(horizontal ? BLUR_HORIZONTAL : 0);
+            bloom_program.use();
+            bloom_program.set_uniform(bloom.image, 0);
             m_bloom_ping_pong_framebuffers[static_cast<int>(horizontal)].bind();
-            m_bloom_program.set_uniform("horizontal", horizontal);
             if (first_iteration)
             {
                 m_post_processing_color_attachment_bright.bind(GL_TEXTURE0);
@@ -335,25 +942,28 @@ void App::render(const double delta_time)
             horizontal = !horizontal;
             first_iteration = false;
         }
+        gl_state.bind_framebuffer(0);
+        glPopDebugGroup();
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glPopDebugGroup();
 
     glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "Post-Processing Render Pass");
     {
-        glDisable(GL_DEPTH_TEST);
-        glDisable(GL_CULL_FACE);
-        m_post_processing_program.use();
-        m_post_processing_program.set_uniform("gamma", m_gamma);
-        m_post_processing_program.set_uniform("exposure", m_exposure);
-        m_post_processing_program.set_uniform("screen_texture", 0);
-        m_post_processing_program.set_uniform("bloom_texture", 1);
+        gl_state.disable(GL_DEPTH_TEST);
+        gl_state.disable(GL_CULL_FACE);
+        auto &[post_processing_program, post_processing] =
+            m_post_processing_variants.get(get_post_processing_features());
+        post_processing_program.use();
+        post_processing_program.set_uniform(post_processing.gamma, m_gamma);
+        post_processing_program.set_uniform(post_processing.exposure, m_exposure);
+        post_processing_program.set_uniform(post_processing.screen_texture, 0);
+        post_processing_program.set_uniform(post_processing.bloom_texture, 1);
         m_post_processing_color_attachment.bind(GL_TEXTURE0);
         m_bloom_ping_pong_attachments[0].bind(GL_TEXTURE1);
         m_post_processing_plane.draw();
     }
     glPopDebugGroup();
 
+    AllocationTracker::set_phase(FramePhase::UI);
     if (m_show_ui)
     {
         glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "ImGui Render Pass");
@@ -364,9 +974,39 @@ void App::render(const double delta_time)
             draw_ui(delta_time);
             ImGui::Render();
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            // The backend restores most of what it touches, but not through the tracker.
+            gl_state.invalidate();
         }
         glPopDebugGroup();
     }
+
+    AllocationTracker::get().end_frame();
+
+    m_lod_benchmark.record(
+        m_shadow_primitives.get_count() + m_geometry_primitives.get_count(),
+        m_shadow_timer.get_time() + m_geometry_timer.get_time()
+    );
+    m_scaling_benchmark.record(
+        delta_time * 1000.0,
+        m_shadow_timer.get_time() + m_geometry_timer.get_time() + m_shading_timer.get_time(),
+        m_shadow_primitives.get_count() + m_geometry_primitives.get_count()
+    );
+    if (m_stress_scene.benchmark && m_scaling_benchmark.is_finished())
+    {
+        glfwSetWindowShouldClose(m_window, GLFW_TRUE);
+    }
+
+    // Changing the scene or the settings grows containers to their new sizes, so the
+    // steady-state check has to settle again.
+    const auto active_models = get_active_model_count();
+    if (active_models != m_last_active_models || ImGui::IsAnyItemActive())
+    {
+        m_last_active_models = active_models;
+        AllocationTracker::get().restart_settling();
+    }
+
+    m_ring_buffer.end_frame();
+    gl_state.end_frame();
 }
 
 void App::draw_ui(const double delta_time)
@@ -385,6 +1025,317 @@ void App::draw_ui(const double delta_time)
     }
     ImGui::End();
 
+    ImGui::Begin(
+        "Renderer",
+        nullptr,
+        ImGuiWindowFlags_NoResize | ImGuiWindowFlags_AlwaysAutoResize
+    );
+    {
+        ImGui::SeparatorText("Culling");
+        ImGui::Checkbox("GPU-driven", &m_gpu_driven);
+        ImGui::Checkbox("Occlusion culling (Hi-Z)", &m_occlusion_culling);
+        ImGui::Checkbox("Meshlet culling", &m_meshlet_culling);
+        ImGui::BeginDisabled(!m_meshlet_culling);
+        ImGui::Checkbox("Cone culling", &m_cone_culling);
+        ImGui::EndDisabled();
+        ImGui::Text(
+            "%u meshlets in %u draws of %u meshes",
+            m_scene_geometry.get_meshlet_count(),
+            m_scene_geometry.get_draw_count(),
+            m_scene_geometry.get_mesh_count()
+        );
+        ImGui::Text("Draw count: %s", m_gpu_culling->is_compacting() ? "GPU" : "CPU");
+
+        ImGui::SeparatorText("Render Queue");
+        ImGui::Checkbox("Sort draws", &m_sort_draws);
+        ImGui::Checkbox("Instancing", &m_instancing);
+        ImGui::Text("Draw list update: %.1f us", m_draw_list_update_time);
+        ImGui::Text("Draw data uploaded: %u", m_uploaded_draws);
+        const auto &shadow_stats = m_shadow_queue.get_stats();
+        ImGui::Text(
+            "Shadow: %u draws in %u commands, %u batches, %u rebuilds",
+            shadow_stats.draws,
+            shadow_stats.commands,
+            shadow_stats.batches,
+            shadow_stats.rebuilds
+        );
+        const auto &geometry_stats = m_geometry_queue.get_stats();
+        ImGui::Text(
+            "Geometry: %u draws in %u commands, %u batches, %u rebuilds",
+            geometry_stats.draws,
+            geometry_stats.commands,
+            geometry_stats.batches,
+            geometry_stats.rebuilds
+        );
+        if (m_shadow_commands && m_geometry_commands)
+        {
+            const auto command_bytes =
+                m_shadow_commands->get_size() + m_geometry_commands->get_size();
+            ImGui::Text(
+                "Command lists: %zu shadow, %zu geometry (%.1f KiB)",
+                m_shadow_commands->get_command_count(),
+                m_geometry_commands->get_command_count(),
+                static_cast<double>(command_bytes) / 1024.0
+            );
+        }
+        ImGui::Text(
+            "Material binds: %u (%u avoided)",
+            geometry_stats.material_binds,
+            geometry_stats.material_binds_avoided
+        );
+        const auto unsorted_invocations =
+            static_cast<unsigned long long>(geometry_stats.fragment_invocations[0]);
+        const auto sorted_invocations =
+            static_cast<unsigned long long>(geometry_stats.fragment_invocations[1]);
+        ImGui::Text("Fragments (unsorted): %llu", unsorted_invocations);
+        ImGui::Text("Fragments (sorted): %llu", sorted_invocations);
+        if (unsorted_invocations != 0 && sorted_invocations != 0)
+        {
+            ImGui::Text(
+                "Early-Z gain: %.1f%%",
+                100.0 * (1.0 - static_cast<double>(sorted_invocations) /
+                                   static_cast<double>(unsorted_invocations))
+            );
+        }
+
+        ImGui::SeparatorText("Geometry");
+        const auto &memory = m_scene_geometry.get_memory_stats();
+        const auto geometry_bytes =
+            memory.vertex_bytes + memory.position_bytes + memory.index_bytes;
+        ImGui::Text(
+            "%s vertices, %d-bit indices",
+            m_scene_geometry.get_vertex_format() == SceneGeometry::VertexFormat::Packed ? "Packed"
+                                                                                        : "Full",
+            m_scene_geometry.get_index_type() == GL_UNSIGNED_SHORT ? 16 : 32
+        );
+        ImGui::Text(
+            "Memory: %.2f MiB (unpacked %.2f MiB)",
+            static_cast<double>(geometry_bytes) / (1024.0 * 1024.0),
+            static_cast<double>(memory.unpacked_bytes) / (1024.0 * 1024.0)
+        );
+        ImGui::Text(
+            "Geometry pass: %.3f ms (average %.3f ms)",
+            m_geometry_timer.get_time(),
+            m_geometry_timer.get_average_time()
+        );
+
+        ImGui::SeparatorText("Levels of Detail");
+        ImGui::BeginDisabled(m_lod_benchmark.is_running() || m_scaling_benchmark.is_running());
+        ImGui::Checkbox("Enabled", &m_lods);
+        ImGui::SliderFloat("Error (pixels)", &m_lod_threshold, 0.25f, 16.0f);
+        ImGui::SliderFloat("Shadow error (texels)", &m_shadow_lod_threshold, 0.25f, 64.0f);
+        if (ImGui::Button("Run benchmark"))
+        {
+            m_lod_benchmark.start();
+        }
+        ImGui::EndDisabled();
+        ImGui::Text(
+            "Triangles: %.3f M shadow, %.3f M geometry",
+            static_cast<double>(m_shadow_primitives.get_count()) / 1e6,
+            static_cast<double>(m_geometry_primitives.get_count()) / 1e6
+        );
+        if (const auto &results = m_lod_benchmark.get_results())
+        {
+            for (std::size_t i = 0; i < results->size(); ++i)
+            {
+                const auto &[triangles, milliseconds] = (*results)[i];
+                ImGui::Text(
+                    "%s: %.3f M triangles, %.3f ms, %.2f G triangles/s",
+                    i == 0 ? "Full detail" : "LODs",
+                    triangles / 1e6,
+                    milliseconds,
+                    milliseconds > 0.0 ? triangles / milliseconds / 1e6 : 0.0
+                );
+            }
+        }
+
+        ImGui::SeparatorText("Scaling");
+        ImGui::BeginDisabled(m_scaling_benchmark.is_running() || m_lod_benchmark.is_running());
+        if (ImGui::Button("Run scaling benchmark"))
+        {
+            m_scaling_benchmark.start(static_cast<int>(m_models.size()));
+        }
+        ImGui::EndDisabled();
+        ImGui::Text("Shading: %.3f ms", m_shading_timer.get_time());
+        for (const auto &result : m_scaling_benchmark.get_results())
+        {
+            ImGui::Text(
+                "%d instances: %.3f ms frame, %.3f ms GPU, %.3f M triangles",
+                result.instances,
+                result.frame_milliseconds,
+                result.gpu_milliseconds,
+                result.triangles / 1e6
+            );
+        }
+
+        ImGui::SeparatorText("Jobs");
+        ImGui::Text("Threads: %zu", m_jobs.get_thread_count());
+        ImGui::BeginDisabled(m_thread_scaling_benchmark.is_running() || m_gpu_driven);
+        if (ImGui::Button("Run thread scaling benchmark"))
+        {
+            m_thread_scaling_benchmark.start(m_jobs.get_thread_count());
+        }
+        ImGui::EndDisabled();
+        for (const auto &result : m_thread_scaling_benchmark.get_results())
+        {
+            ImGui::Text(
+                "%zu threads: %.3f ms, %.2fx",
+                result.threads,
+                result.milliseconds,
+                result.speedup
+            );
+        }
+
+        ImGui::SeparatorText("Ring Buffer");
+        const auto &ring_stats = m_ring_buffer.get_stats();
+        ImGui::Text(
+            "Used: %.1f KiB (peak %.1f KiB of %.1f KiB)",
+            static_cast<double>(ring_stats.used) / 1024.0,
+            static_cast<double>(ring_stats.high_water_mark) / 1024.0,
+            static_cast<double>(m_ring_buffer.get_frame_size()) / 1024.0
+        );
+        ImGui::Text(
+            "Stalls: %llu (last %.1f us, total %.1f ms)",
+            static_cast<unsigned long long>(ring_stats.stalls),
+            ring_stats.last_wait_time,
+            ring_stats.total_wait_time / 1000.0
+        );
+
+        ImGui::SeparatorText("Frame Arenas");
+        const auto arena_stats = m_frame_arenas.get_stats();
+        ImGui::Text(
+            "Used: %.1f KiB in %zu threads",
+            static_cast<double>(arena_stats.used) / 1024.0,
+            m_frame_arenas.get_thread_count()
+        );
+        ImGui::Text(
+            "Peak: %.1f KiB of %.1f KiB per arena, %llu overflows",
+            static_cast<double>(arena_stats.high_water_mark) / 1024.0,
+            static_cast<double>(m_frame_arenas.get_arena_size()) / 1024.0,
+            static_cast<unsigned long long>(arena_stats.overflows)
+        );
+
+        ImGui::SeparatorText("Allocations");
+        if (AllocationTracker::is_enabled())
+        {
+            auto &tracker = AllocationTracker::get();
+            for (std::size_t i = 0; i < AllocationTracker::PHASE_COUNT; ++i)
+            {
+                const auto phase = static_cast<FramePhase>(i);
+                const auto &counter = tracker.get_last_frame(phase);
+                ImGui::Text(
+                    "%s: %llu (%llu bytes)",
+                    AllocationTracker::get_phase_name(phase),
+                    static_cast<unsigned long long>(counter.allocations),
+                    static_cast<unsigned long long>(counter.bytes)
+                );
+            }
+            auto steady_state = tracker.is_steady_state_check_enabled();
+            if (ImGui::Checkbox("Fail on steady-state allocations", &steady_state))
+            {
+                tracker.set_steady_state_check(steady_state);
+            }
+        }
+        else
+        {
+            ImGui::TextDisabled("Configure with SPONZA_TRACK_ALLOCATIONS=ON to count them.");
+        }
+
+        ImGui::SeparatorText("GL State");
+        auto filtering = GLState::get().is_filtering();
+        if (ImGui::Checkbox("Filter redundant calls", &filtering))
+        {
+            GLState::get().set_filtering(filtering);
+        }
+        const auto &gl_stats = GLState::get().get_stats();
+        ImGui::Text("State calls issued: %llu", static_cast<unsigned long long>(gl_stats.issued));
+        ImGui::Text(
+            "State calls redundant: %llu",
+            static_cast<unsigned long long>(gl_stats.redundant)
+        );
+
+        ImGui::SeparatorText("GL Objects");
+        const auto &gl_objects = GLObjectRegistry::get();
+        for (std::size_t i = 0; i < GLObjectRegistry::TYPE_COUNT; ++i)
+        {
+            const auto type = static_cast<GLObjectType>(i);
+            const auto &entry = gl_objects.get_entry(type);
+            ImGui::Text(
+                "%s: %lld live, %.2f MiB (%llu created)",
+                GLObjectRegistry::get_type_name(type),
+                static_cast<long long>(entry.live),
+                static_cast<double>(entry.bytes) / (1024.0 * 1024.0),
+                static_cast<unsigned long long>(entry.created)
+            );
+        }
+
+        ImGui::SeparatorText("Shaders");
+        for (const auto *program : m_shader_watcher.get_programs())
+        {
+            ImGui::Text(
+                "%s: %u reloads%s",
+                program->get_name().c_str(),
+                program->get_reload_count(),
+                program->is_reloading() ? " (compiling)" : ""
+            );
+            if (!program->get_error().empty())
+            {
+                ImGui::TextColored({1.0f, 0.3f, 0.3f, 1.0f}, "%s", program->get_error().c_str());
+            }
+        }
+        for (const auto *error :
+             {&m_bloom_variants.get_error(),
+              &m_deferred_shading_variants.get_error(),
+              &m_post_processing_variants.get_error()})
+        {
+            if (!error->empty())
+            {
+                ImGui::TextColored({1.0f, 0.3f, 0.3f, 1.0f}, "%s", error->c_str());
+            }
+        }
+    }
+    ImGui::End();
+
+    ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_AlwaysAutoResize);
+    {
+        ImGui::SeparatorText("Model");
+        const auto model_count = static_cast<int>(m_models.size());
+        if (model_count > 1)
+        {
+            ImGui::BeginDisabled(m_scaling_benchmark.is_running());
+            ImGui::SliderInt("Active instances", &m_active_models, 1, model_count);
+            ImGui::EndDisabled();
+            ImGui::SliderInt("Instance", &m_selected_model, 0, model_count - 1);
+        }
+        auto &model = m_models[std::clamp(m_selected_model, 0, model_count - 1)];
+        auto transform = model.m_transform;
+        auto changed = ImGui::SliderFloat3(
+            "Position",
+            glm::value_ptr(transform.m_position),
+            -3'000.0f,
+            3'000.0f
+        );
+        changed |= ImGui::SliderFloat3(
+            "Rotation",
+            glm::value_ptr(transform.m_rotation),
+            0.0f,
+            359.999f
+        );
+        changed |= ImGui::SliderFloat3("Scale", glm::value_ptr(transform.m_scale), 0.01f, 10.0f);
+        if (changed)
+        {
+            set_model_transform(model, transform);
+        }
+        ImGui::Text("Point lights: %zu", m_point_lights.size());
+        ImGui::Text(
+            "Scene graph: %u nodes, %zu updated in %.1f us",
+            m_scene_graph.get_node_count(),
+            m_updated_nodes,
+            m_transform_update_time
+        );
+    }
+    ImGui::End();
+
     ImGui::Begin("Light", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_AlwaysAutoResize);
     {
         ImGui::SeparatorText("Transform");
@@ -420,6 +1371,13 @@ void App::draw_ui(const double delta_time)
         ImGui::SliderFloat("Z Far", &m_sun.m_z_far, 0.0f, 100'000.0f);
 
         ImGui::SeparatorText("Shadow Map");
+        ImGui::Text(
+            "Shadow pass: %.3f ms (average %.3f ms)",
+            m_shadow_timer.get_time(),
+            m_shadow_timer.get_average_time()
+        );
+        static constexpr std::array<const char *, 3> pcf_kernels{"1x1", "3x3", "5x5"};
+        ImGui::Combo("PCF Kernel", &m_pcf_radius, pcf_kernels.data(), pcf_kernels.size());
         ImGui::Image(m_shadow_map_depth_attachment.get_handle(), ImVec2(256, 256));
     }
     ImGui::End();
@@ -432,14 +1390,43 @@ void App::draw_ui(const double delta_time)
     {
         ImGui::SliderFloat("Gamma", &m_gamma, 0.0f, 3.0f);
         ImGui::SliderFloat("Exposure", &m_exposure, 0.0f, 10.0f);
+        ImGui::Checkbox("Bloom", &m_bloom);
         ImGui::SliderInt("Bloom Steps", &m_bloom_amount, 0, 10);
     }
     ImGui::End();
 }
 
+void App::resolve_bloom_uniforms(ShaderProgram &program, BloomUniforms &uniforms)
+{
+    uniforms.image = program.get_uniform<int>("image");
+}
+
+void App::resolve_deferred_shading_uniforms(
+    ShaderProgram &program, DeferredShadingUniforms &uniforms
+)
+{
+    program.check_block("FrameData", FRAME_DATA_BINDING, sizeof(FrameData));
+    program.check_block("SunData", SUN_DATA_BINDING, sizeof(SunData));
+    uniforms.shadow_map = program.get_uniform<int>("shadow_map");
+    uniforms.albedo_map = program.get_uniform<int>("albedo_map");
+    uniforms.positions_map = program.get_uniform<int>("positions_map");
+    uniforms.normals_map = program.get_uniform<int>("normals_map");
+    uniforms.point_light_count = program.get_uniform<GLuint>("point_light_count");
+}
+
+void App::resolve_post_processing_uniforms(
+    ShaderProgram &program, PostProcessingUniforms &uniforms
+)
+{
+    uniforms.gamma = program.get_uniform<float>("gamma");
+    uniforms.exposure = program.get_uniform<float>("exposure");
+    uniforms.screen_texture = program.get_uniform<int>("screen_texture");
+    uniforms.bloom_texture = program.get_uniform<int>("bloom_texture");
+}
+
 void App::framebuffer_size_callback(GLFWwindow *window, const int width, const int height)
 {
-    glViewport(0, 0, width, height);
+    GLState::get().viewport(0, 0, width, height);
 }
 
 void App::glfw_error_callback(int error, const char *desc)
@@ -1,20 +1,42 @@
 #ifndef APP_H
 #define APP_H
 
+#include <algorithm>
 #include <array>
-#include <memory>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
 
 #include <GLFW/glfw3.h>
 #include <assimp/Importer.hpp>
 
 #include "Camera.h"
+#include "CommandList.h"
 #include "DirectionalLight.h"
+#include "FrameArenas.h"
+#include "FrameData.h"
 #include "Framebuffer.h"
+#include "GpuCulling.h"
+#include "GpuTimer.h"
+#include "JobSystem.h"
+#include "LodBenchmark.h"
+#include "Material.h"
 #include "Mesh.h"
 #include "Model.h"
 #include "PointLight.h"
+#include "PrimitiveCounter.h"
+#include "RenderQueue.h"
+#include "ResourceRegistry.h"
+#include "RingBuffer.h"
+#include "ScalingBenchmark.h"
+#include "SceneGeometry.h"
+#include "SceneGraph.h"
 #include "ShaderProgram.h"
+#include "ShaderVariants.h"
+#include "ShaderWatcher.h"
 #include "Texture.h"
+#include "ThreadScalingBenchmark.h"
 
 class App
 {
@@ -22,11 +44,45 @@ class App
     static constexpr int SHADOW_MAP_SIZE = 4096;
     static constexpr std::uint32_t WINDOW_WIDTH = 1280;
     static constexpr std::uint32_t WINDOW_HEIGHT = 720;
+    static constexpr float DRAW_LIST_RESORT_DISTANCE = 100.0f;
+    static constexpr float DRAW_LIST_RESORT_COSINE = 0.97f;
+    static constexpr GLsizeiptr RING_BUFFER_FRAME_SIZE = 8 * 1024 * 1024;
+    static constexpr std::size_t FRAME_ARENA_SIZE = 256 * 1024;
+    static constexpr std::uint32_t LOD_SELECTION_GRAIN = 1024;
+    // The distance between instances of the stress scene, relative to the model's extent.
+    static constexpr float STRESS_GRID_SPACING = 1.25f;
+    // The range of the random point lights, in model units.
+    static constexpr float STRESS_LIGHT_RANGE = 400.0f;
+    static constexpr GLuint NO_DRAW = ~0u;
+
+    // A synthetic scene for scaling benchmarks, built from the loaded model, see main.cpp.
+    struct StressScene
+    {
+        // Instances of the model on a grid, filled in Z-order so that the first 4^n instances
+        // form a square.
+        int columns{1};
+        int rows{1};
+        int point_lights{0};
+        // Jitters the position, rotation and scale of every instance but the first.
+        bool randomize{false};
+        std::uint32_t seed{1};
+        // Runs the scaling benchmark on startup and exits when it is done.
+        bool benchmark{false};
+    };
+
+    // Shader features, defined in the shaders under the names passed to their ShaderVariants.
+    static constexpr ShaderFeatures BLUR_HORIZONTAL = 1u << 0;
+    static constexpr ShaderFeatures SHADING_PCF_3X3 = 1u << 0;
+    static constexpr ShaderFeatures SHADING_PCF_5X5 = 1u << 1;
+    static constexpr ShaderFeatures SHADING_BLOOM = 1u << 2;
+    static constexpr ShaderFeatures POST_PROCESSING_BLOOM = 1u << 0;
 
   private:
     Assimp::Importer m_assimp_importer;
 
     GLFWwindow *m_window;
+    // Declared first, so that it outlives the handles to its resources.
+    ResourceRegistry m_resources;
 
     Camera m_camera{
         .m_eye = {-1250.0f, 85.0f, 75.0f},
@@ -53,60 +109,175 @@ class App
         .m_z_far = 10000.0f,
     };
 
+    JobSystem m_jobs{std::max(std::thread::hardware_concurrency(), 1u)};
+    RingBuffer m_ring_buffer{RING_BUFFER_FRAME_SIZE};
+    // One arena per thread of the job system.
+    FrameArenas m_frame_arenas{m_jobs.get_thread_count(), FRAME_ARENA_SIZE};
+    ShaderWatcher m_shader_watcher{"./shaders"};
+
     ShaderProgram m_depth_program;
     Texture m_shadow_map_depth_attachment{
         Texture::depth_attachment(SHADOW_MAP_SIZE, SHADOW_MAP_SIZE)
     };
     Framebuffer m_shadow_map_framebuffer;
+    GpuTimer m_shadow_timer;
+    PrimitiveCounter m_shadow_primitives;
 
+    bool m_bloom{true};
     int m_bloom_amount{1};
-    ShaderProgram m_bloom_program;
+    struct BloomUniforms
+    {
+        UniformHandle<int> image;
+    };
+    ShaderVariants<BloomUniforms> m_bloom_variants{
+        {
+            {GL_VERTEX_SHADER, "./shaders/postprocessing.vert.glsl"},
+            {GL_FRAGMENT_SHADER, "./shaders/gaussian.frag.glsl"},
+        },
+        {"HORIZONTAL"},
+        resolve_bloom_uniforms,
+        m_shader_watcher,
+    };
     std::array<Texture, 2> m_bloom_ping_pong_attachments{
-        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F, GL_RGBA),
-        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F, GL_RGBA),
+        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F),
+        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F),
     };
     std::array<Framebuffer, 2> m_bloom_ping_pong_framebuffers;
 
     ShaderProgram m_geometry_program;
-    Texture m_g_buffer_albedo{Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGB, GL_RGB)
-    };
+    struct
+    {
+        UniformHandle<int> diffuse_map;
+        UniformHandle<int> normal_map;
+    } m_geometry_uniforms;
+    Texture m_g_buffer_albedo{Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGB8)};
     Texture m_g_buffer_positions{
-        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F, GL_RGBA)
+        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F)
     };
     Texture m_g_buffer_normals{
-        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGB16F, GL_RGB)
+        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGB16F)
     };
     Texture m_g_buffer_depth{Texture::depth_attachment(WINDOW_WIDTH, WINDOW_HEIGHT)};
     Framebuffer m_geometry_buffer;
+    GpuTimer m_geometry_timer;
+    PrimitiveCounter m_geometry_primitives;
+    GpuTimer m_shading_timer;
 
-    ShaderProgram m_deferred_shading_program;
+    // Radius of the PCF kernel used to filter the shadow map.
+    int m_pcf_radius{1};
+    struct DeferredShadingUniforms
+    {
+        UniformHandle<int> shadow_map;
+        UniformHandle<int> albedo_map;
+        UniformHandle<int> positions_map;
+        UniformHandle<int> normals_map;
+        UniformHandle<GLuint> point_light_count;
+    };
+    ShaderVariants<DeferredShadingUniforms> m_deferred_shading_variants{
+        {
+            {GL_VERTEX_SHADER, "./shaders/deferred_shading.vert.glsl"},
+            {GL_FRAGMENT_SHADER, "./shaders/deferred_shading.frag.glsl"},
+        },
+        {"PCF_3X3", "PCF_5X5", "BLOOM"},
+        resolve_deferred_shading_uniforms,
+        m_shader_watcher,
+    };
 
     Texture m_post_processing_color_attachment{
-        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F, GL_RGBA)
+        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F)
     };
     Texture m_post_processing_color_attachment_bright{
-        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F, GL_RGBA)
+        Texture::color_attachment(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA16F)
     };
     Framebuffer m_post_processing_framebuffer;
 
-    ShaderProgram m_post_processing_program;
+    struct PostProcessingUniforms
+    {
+        UniformHandle<float> gamma;
+        UniformHandle<float> exposure;
+        UniformHandle<int> screen_texture;
+        UniformHandle<int> bloom_texture;
+    };
+    ShaderVariants<PostProcessingUniforms> m_post_processing_variants{
+        {
+            {GL_VERTEX_SHADER, "./shaders/postprocessing.vert.glsl"},
+            {GL_FRAGMENT_SHADER, "./shaders/postprocessing.frag.glsl"},
+        },
+        {"BLOOM"},
+        resolve_post_processing_uniforms,
+        m_shader_watcher,
+    };
     Mesh m_post_processing_plane{Mesh::plane()};
     float m_gamma{2.2f};
     float m_exposure{1.0f};
 
     ShaderProgram m_skybox_program;
-    std::shared_ptr<Texture> m_skybox_texture{Texture::from_file_cubemap(std::array<std::string, 6>{
-        "./assets/skybox/px.png",
-        "./assets/skybox/nx.png",
-        "./assets/skybox/py.png",
-        "./assets/skybox/ny.png",
-        "./assets/skybox/pz.png",
-        "./assets/skybox/nz.png",
-    })};
+    struct
+    {
+        UniformHandle<int> cubemap;
+    } m_skybox_uniforms;
+    TextureHandle m_skybox_texture{
+        m_resources.add_texture(Texture::from_file_cubemap(std::array<std::string, 6>{
+            "./assets/skybox/px.png",
+            "./assets/skybox/nx.png",
+            "./assets/skybox/py.png",
+            "./assets/skybox/ny.png",
+            "./assets/skybox/pz.png",
+            "./assets/skybox/nz.png",
+        }))
+    };
     Mesh m_skybox_mesh{Mesh::skybox()};
 
+    // The loaded model first, then the other instances of the stress scene.
     std::vector<Model> m_models;
-    std::vector<std::shared_ptr<Material>> m_materials;
+    SceneGraph m_scene_graph;
+    // The draw placed by each scene graph node, or NO_DRAW.
+    std::vector<GLuint> m_node_draws;
+    std::size_t m_updated_nodes{};
+    double m_transform_update_time{};
+    // Indexed by the material ids of the draws.
+    std::vector<MaterialHandle> m_materials;
+    std::vector<MaterialTextures> m_material_textures;
+    StressScene m_stress_scene;
+    int m_active_models{1};
+    int m_selected_model{0};
+    // The active model count of the previous frame, to notice changes to the scene.
+    int m_last_active_models{0};
+    ScalingBenchmark m_scaling_benchmark;
+    ThreadScalingBenchmark m_thread_scaling_benchmark;
+
+    SceneGeometry m_scene_geometry;
+    std::optional<GpuCulling> m_gpu_culling;
+    bool m_gpu_driven{false};
+    bool m_occlusion_culling{true};
+    bool m_meshlet_culling{true};
+    bool m_cone_culling{true};
+
+    bool m_lods{true};
+    // The largest error of a level of detail on screen, and in shadow map texels.
+    float m_lod_threshold{1.0f};
+    float m_shadow_lod_threshold{4.0f};
+    LodBenchmark m_lod_benchmark;
+
+    RenderQueue m_shadow_queue{m_scene_geometry};
+    RenderQueue m_geometry_queue{m_scene_geometry};
+    bool m_sort_draws{true};
+    bool m_instancing{true};
+    glm::vec3 m_draw_list_eye{0.0f};
+    glm::vec3 m_draw_list_forward{0.0f};
+    float m_shadow_list_lod_scale{-1.0f};
+    float m_geometry_list_lod_scale{-1.0f};
+    // The level of detail of every active draw in each view, when its list was last recorded.
+    std::vector<GLuint> m_shadow_draw_lods;
+    std::vector<GLuint> m_camera_draw_lods;
+    GLuint m_uploaded_draws{};
+    double m_draw_list_update_time{};
+    // Recorded every frame into the frame arena of the recording thread, empty in GPU-driven mode.
+    std::optional<CommandList> m_shadow_commands;
+    std::optional<CommandList> m_geometry_commands;
+
+    std::vector<PointLight> m_point_lights;
+    std::optional<Buffer> m_point_light_buffer;
 
     PointLight m_light{
         .m_position = {1.2f, 0.0f, -2.0f},
@@ -121,15 +292,43 @@ class App
     bool m_show_ui{true};
 
   public:
-    explicit App(GLFWwindow *window);
+    explicit App(
+        GLFWwindow *window, SceneGeometry::VertexFormat vertex_format,
+        const StressScene &stress_scene
+    );
     int run();
 
     static void glfw_error_callback(int error, const char *desc);
 
   private:
+    // Adds the instances of the stress scene, before the scene geometry is uploaded.
+    void build_stress_scene();
+    void upload_point_lights();
+    [[nodiscard]] int get_active_model_count() const;
+    void update_draw_lists();
+    // Records the shadow and geometry passes into their command lists on the job system.
+    void record_command_lists();
+    // Uploads the FrameData and SunData blocks shared by all shaders.
+    void update_uniform_blocks();
+    void set_model_transform(Model &model, const Transform &transform);
+    // Applies the world matrices of the scene graph nodes that changed to their draws.
+    void update_transforms();
+    [[nodiscard]] ShaderFeatures get_deferred_shading_features() const;
+    [[nodiscard]] ShaderFeatures get_post_processing_features() const;
+    // See SceneGeometry::select_lod.
+    [[nodiscard]] float get_camera_lod_scale() const;
+    [[nodiscard]] float get_shadow_lod_scale() const;
     void render(const double delta_time);
     void draw_ui(const double delta_time);
 
+    static void resolve_bloom_uniforms(ShaderProgram &program, BloomUniforms &uniforms);
+    static void resolve_deferred_shading_uniforms(
+        ShaderProgram &program, DeferredShadingUniforms &uniforms
+    );
+    static void resolve_post_processing_uniforms(
+        ShaderProgram &program, PostProcessingUniforms &uniforms
+    );
+
     static void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 
     static void GLAPIENTRY debug_message_callback(
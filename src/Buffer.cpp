@@ -0,0 +1,48 @@
+#include "Buffer.h"
+
+#include "GLState.h"
+
+Buffer::Buffer(const GLsizeiptr size, const void *data, const GLbitfield flags)
+    : m_buffer(BufferObject::create())
+{
+    glNamedBufferStorage(m_buffer.get(), size, data, flags);
+    m_buffer.set_size(size);
+}
+
+void Buffer::upload(const GLintptr offset, const GLsizeiptr size, const void *data)
+{
+    glNamedBufferSubData(m_buffer.get(), offset, size, data);
+}
+
+void Buffer::clear(const GLintptr offset, const GLsizeiptr size)
+{
+    glClearNamedBufferSubData(
+        m_buffer.get(),
+        GL_R32UI,
+        offset,
+        size,
+        GL_RED_INTEGER,
+        GL_UNSIGNED_INT,
+        nullptr
+    );
+}
+
+void Buffer::bind(const GLenum target) const
+{
+    GLState::get().bind_buffer(target, m_buffer.get());
+}
+
+void Buffer::bind_base(const GLenum target, const GLuint index) const
+{
+    GLState::get().bind_buffer_base(target, index, m_buffer.get());
+}
+
+GLuint Buffer::get_handle() const
+{
+    return m_buffer.get();
+}
+
+GLsizeiptr Buffer::get_size() const
+{
+    return m_buffer.get_size();
+}
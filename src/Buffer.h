@@ -0,0 +1,31 @@
+#ifndef BUFFER_H
+#define BUFFER_H
+
+#include <glad/glad.h>
+
+#include "GLObject.h"
+
+class Buffer
+{
+    BufferObject m_buffer;
+
+  public:
+    explicit Buffer(
+        GLsizeiptr size, const void *data = nullptr, GLbitfield flags = GL_DYNAMIC_STORAGE_BIT
+    );
+    Buffer(const Buffer &) = delete;
+    const Buffer &operator=(const Buffer &) = delete;
+    Buffer(Buffer &&) = default;
+    Buffer &operator=(Buffer &&) = default;
+
+    void upload(GLintptr offset, GLsizeiptr size, const void *data);
+    void clear(GLintptr offset, GLsizeiptr size);
+
+    void bind(GLenum target) const;
+    void bind_base(GLenum target, GLuint index) const;
+
+    [[nodiscard]] GLuint get_handle() const;
+    [[nodiscard]] GLsizeiptr get_size() const;
+};
+
+#endif // BUFFER_H
@@ -0,0 +1,174 @@
+#include "CommandList.h"
+
+#include <stdexcept>
+
+#include "GLState.h"
+
+CommandList::CommandList(std::pmr::memory_resource *memory) : m_data(memory)
+{
+}
+
+void CommandList::clear()
+{
+    m_data.clear();
+    m_command_count = 0;
+}
+
+void CommandList::use_program(ShaderProgram &program)
+{
+    push(UseProgram{.type = CommandType::UseProgram, .program = &program});
+}
+
+void CommandList::set_uniform(
+    ShaderProgram &program, const UniformHandle<int> uniform, const int value
+)
+{
+    push(SetUniformInt{
+        .type = CommandType::SetUniformInt,
+        .uniform = uniform,
+        .value = value,
+        .program = &program,
+    });
+}
+
+void CommandList::bind_vertex_array(const GLuint vertex_array)
+{
+    push(BindVertexArray{.type = CommandType::BindVertexArray, .vertex_array = vertex_array});
+}
+
+void CommandList::bind_buffer(const GLenum target, const GLuint buffer)
+{
+    push(BindBuffer{.type = CommandType::BindBuffer, .target = target, .buffer = buffer});
+}
+
+void CommandList::bind_buffer_base(const GLenum target, const GLuint index, const GLuint buffer)
+{
+    push(BindBufferBase{
+        .type = CommandType::BindBufferBase,
+        .target = target,
+        .index = index,
+        .buffer = buffer,
+    });
+}
+
+void CommandList::bind_texture(const GLuint unit, const GLenum target, const GLuint texture)
+{
+    push(BindTexture{
+        .type = CommandType::BindTexture,
+        .target = target,
+        .unit = unit,
+        .texture = texture,
+    });
+}
+
+void CommandList::begin_query(const GLenum target, const GLuint query)
+{
+    push(BeginQuery{.type = CommandType::BeginQuery, .target = target, .query = query});
+}
+
+void CommandList::end_query(const GLenum target)
+{
+    push(EndQuery{.type = CommandType::EndQuery, .target = target});
+}
+
+void CommandList::multi_draw_elements_indirect(
+    const GLenum mode, const GLenum index_type, const GLintptr offset, const GLsizei count
+)
+{
+    push(MultiDrawElementsIndirect{
+        .type = CommandType::MultiDrawElementsIndirect,
+        .mode = mode,
+        .index_type = index_type,
+        .count = count,
+        .offset = offset,
+    });
+}
+
+void CommandList::replay() const
+{
+    auto &gl_state = GLState::get();
+    for (std::size_t offset = 0; offset < m_data.size();)
+    {
+        switch (static_cast<CommandType>(m_data[offset]))
+        {
+            case CommandType::UseProgram:
+            {
+                read<UseProgram>(offset).program->use();
+                offset += get_stride<UseProgram>();
+                break;
+            }
+            case CommandType::SetUniformInt:
+            {
+                const auto command = read<SetUniformInt>(offset);
+                command.program->set_uniform(command.uniform, command.value);
+                offset += get_stride<SetUniformInt>();
+                break;
+            }
+            case CommandType::BindVertexArray:
+            {
+                gl_state.bind_vertex_array(read<BindVertexArray>(offset).vertex_array);
+                offset += get_stride<BindVertexArray>();
+                break;
+            }
+            case CommandType::BindBuffer:
+            {
+                const auto command = read<BindBuffer>(offset);
+                gl_state.bind_buffer(command.target, command.buffer);
+                offset += get_stride<BindBuffer>();
+                break;
+            }
+            case CommandType::BindBufferBase:
+            {
+                const auto command = read<BindBufferBase>(offset);
+                gl_state.bind_buffer_base(command.target, command.index, command.buffer);
+                offset += get_stride<BindBufferBase>();
+                break;
+            }
+            case CommandType::BindTexture:
+            {
+                const auto command = read<BindTexture>(offset);
+                gl_state.bind_texture(command.unit, command.target, command.texture);
+                offset += get_stride<BindTexture>();
+                break;
+            }
+            case CommandType::BeginQuery:
+            {
+                const auto command = read<BeginQuery>(offset);
+                glBeginQuery(command.target, command.query);
+                offset += get_stride<BeginQuery>();
+                break;
+            }
+            case CommandType::EndQuery:
+            {
+                glEndQuery(read<EndQuery>(offset).target);
+                offset += get_stride<EndQuery>();
+                break;
+            }
+            case CommandType::MultiDrawElementsIndirect:
+            {
+                const auto command = read<MultiDrawElementsIndirect>(offset);
+                glMultiDrawElementsIndirect(
+                    command.mode,
+                    command.index_type,
+                    reinterpret_cast<const void *>(command.offset),
+                    command.count,
+                    0
+                );
+                offset += get_stride<MultiDrawElementsIndirect>();
+                break;
+            }
+            default:
+                throw std::runtime_error("corrupt command list");
+        }
+    }
+}
+
+std::size_t CommandList::get_command_count() const
+{
+    return m_command_count;
+}
+
+std::size_t CommandList::get_size() const
+{
+    return m_data.size();
+}
@@ -0,0 +1,161 @@
+#ifndef COMMAND_LIST_H
+#define COMMAND_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "ShaderProgram.h"
+
+// GL commands recorded into a flat byte array, so that what a pass draws can be decided on any
+// thread while the GL calls themselves are made on the GL thread by `replay`. Every command is a
+// trivially copyable struct that starts with its type, padded to 8 bytes. Replaying is one switch
+// per command, through GLState, so redundant binds are still filtered.
+//
+// Recording does not touch GL. GL names and programs are captured as they are when recorded, so
+// the objects must stay alive until the list has been replayed.
+class CommandList
+{
+  public:
+    enum class CommandType : std::uint8_t
+    {
+        UseProgram,
+        SetUniformInt,
+        BindVertexArray,
+        BindBuffer,
+        BindBufferBase,
+        BindTexture,
+        BeginQuery,
+        EndQuery,
+        MultiDrawElementsIndirect,
+    };
+
+  private:
+    static constexpr std::size_t ALIGNMENT = 8;
+
+    struct UseProgram
+    {
+        CommandType type;
+        ShaderProgram *program;
+    };
+
+    // Goes through the program, so that its cache of uniform values stays correct.
+    struct SetUniformInt
+    {
+        CommandType type;
+        UniformHandle<int> uniform;
+        int value;
+        ShaderProgram *program;
+    };
+
+    struct BindVertexArray
+    {
+        CommandType type;
+        GLuint vertex_array;
+    };
+
+    struct BindBuffer
+    {
+        CommandType type;
+        GLenum target;
+        GLuint buffer;
+    };
+
+    struct BindBufferBase
+    {
+        CommandType type;
+        GLenum target;
+        GLuint index;
+        GLuint buffer;
+    };
+
+    struct BindTexture
+    {
+        CommandType type;
+        GLenum target;
+        GLuint unit;
+        GLuint texture;
+    };
+
+    struct BeginQuery
+    {
+        CommandType type;
+        GLenum target;
+        GLuint query;
+    };
+
+    struct EndQuery
+    {
+        CommandType type;
+        GLenum target;
+    };
+
+    struct MultiDrawElementsIndirect
+    {
+        CommandType type;
+        GLenum mode;
+        GLenum index_type;
+        GLsizei count;
+        // Into the bound draw indirect buffer.
+        GLintptr offset;
+    };
+
+    std::pmr::vector<std::byte> m_data;
+    std::size_t m_command_count{};
+
+  public:
+    // The commands are stored in `memory`, e.g. the frame arena of the recording thread.
+    explicit CommandList(std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    CommandList(const CommandList &) = delete;
+    const CommandList &operator=(const CommandList &) = delete;
+
+    void clear();
+
+    void use_program(ShaderProgram &program);
+    void set_uniform(ShaderProgram &program, UniformHandle<int> uniform, int value);
+    void bind_vertex_array(GLuint vertex_array);
+    void bind_buffer(GLenum target, GLuint buffer);
+    void bind_buffer_base(GLenum target, GLuint index, GLuint buffer);
+    void bind_texture(GLuint unit, GLenum target, GLuint texture);
+    void begin_query(GLenum target, GLuint query);
+    void end_query(GLenum target);
+    void multi_draw_elements_indirect(
+        GLenum mode, GLenum index_type, GLintptr offset, GLsizei count
+    );
+
+    // Issues the recorded commands. Only on the GL thread.
+    void replay() const;
+
+    [[nodiscard]] std::size_t get_command_count() const;
+    [[nodiscard]] std::size_t get_size() const;
+
+  private:
+    template <typename T> void push(const T &command)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto offset = m_data.size();
+        m_data.resize(offset + get_stride<T>());
+        std::memcpy(m_data.data() + offset, &command, sizeof(T));
+        ++m_command_count;
+    }
+
+    // Copied out instead of cast, since the bytes are not guaranteed to hold a T.
+    template <typename T> [[nodiscard]] T read(const std::size_t offset) const
+    {
+        T command;
+        std::memcpy(&command, m_data.data() + offset, sizeof(T));
+        return command;
+    }
+
+    template <typename T> static constexpr std::size_t get_stride()
+    {
+        return (sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+};
+
+#endif // COMMAND_LIST_H
@@ -0,0 +1,79 @@
+#include "FrameArenas.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+FrameArenas::FrameArenas(const std::size_t thread_count, const std::size_t arena_size)
+    : m_thread_count(thread_count),
+      m_arena_size(arena_size)
+{
+    if (thread_count == 0)
+    {
+        throw std::runtime_error("frame arenas need at least one thread");
+    }
+
+    m_arenas.reserve(thread_count * BUFFER_COUNT);
+    for (std::size_t i = 0; i < thread_count * BUFFER_COUNT; ++i)
+    {
+        m_arenas.push_back(std::make_unique<LinearArena>(arena_size));
+    }
+}
+
+void FrameArenas::begin_frame()
+{
+    m_buffer = (m_buffer + 1) % BUFFER_COUNT;
+    for (std::size_t thread = 0; thread < m_thread_count; ++thread)
+    {
+        get(thread).reset();
+    }
+}
+
+LinearArena &FrameArenas::get(const std::size_t thread)
+{
+    if (thread >= m_thread_count)
+    {
+        throw std::runtime_error(
+            fmt::format("no frame arena for thread {} of {}", thread, m_thread_count)
+        );
+    }
+    return *m_arenas[thread * BUFFER_COUNT + m_buffer];
+}
+
+LinearArena &FrameArenas::get_previous(const std::size_t thread)
+{
+    if (thread >= m_thread_count)
+    {
+        throw std::runtime_error(
+            fmt::format("no frame arena for thread {} of {}", thread, m_thread_count)
+        );
+    }
+    return *m_arenas[thread * BUFFER_COUNT + (m_buffer + BUFFER_COUNT - 1) % BUFFER_COUNT];
+}
+
+FrameArenas::Stats FrameArenas::get_stats() const
+{
+    Stats stats;
+    for (std::size_t i = 0; i < m_arenas.size(); ++i)
+    {
+        const auto &arena_stats = m_arenas[i]->get_stats();
+        if (i % BUFFER_COUNT == m_buffer)
+        {
+            stats.used += arena_stats.used;
+        }
+        stats.high_water_mark = std::max(stats.high_water_mark, arena_stats.high_water_mark);
+        stats.overflows += arena_stats.overflows;
+    }
+    return stats;
+}
+
+std::size_t FrameArenas::get_thread_count() const
+{
+    return m_thread_count;
+}
+
+std::size_t FrameArenas::get_arena_size() const
+{
+    return m_arena_size;
+}
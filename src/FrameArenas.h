@@ -0,0 +1,58 @@
+#ifndef FRAME_ARENAS_H
+#define FRAME_ARENAS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "LinearArena.h"
+
+// Containers whose contents only live for a frame, allocated from a FrameArenas arena.
+template <typename T> using FrameVector = std::pmr::vector<T>;
+
+// Linear arenas for data that is rebuilt every frame, one per thread and frame. There are two
+// arenas per thread, so that what was built in the previous frame can still be read while the
+// current frame builds its own. Thread 0 is the render thread.
+class FrameArenas
+{
+  public:
+    static constexpr std::size_t BUFFER_COUNT = 2;
+
+    struct Stats
+    {
+        // Summed over the arenas of the current frame.
+        std::size_t used{};
+        // The most any single arena has held.
+        std::size_t high_water_mark{};
+        std::uint64_t overflows{};
+    };
+
+  private:
+    std::size_t m_thread_count;
+    std::size_t m_arena_size;
+    // Indexed by thread * BUFFER_COUNT + buffer.
+    std::vector<std::unique_ptr<LinearArena>> m_arenas;
+    std::size_t m_buffer{};
+
+  public:
+    explicit FrameArenas(std::size_t thread_count, std::size_t arena_size);
+    FrameArenas(const FrameArenas &) = delete;
+    const FrameArenas &operator=(const FrameArenas &) = delete;
+
+    // Switches to the other arenas and frees what was allocated from them two frames ago.
+    void begin_frame();
+
+    // The arena of the thread for the current frame.
+    [[nodiscard]] LinearArena &get(std::size_t thread = 0);
+    // The arena of the thread for the previous frame. Its allocations stay valid until the next
+    // `begin_frame`.
+    [[nodiscard]] LinearArena &get_previous(std::size_t thread = 0);
+
+    [[nodiscard]] Stats get_stats() const;
+    [[nodiscard]] std::size_t get_thread_count() const;
+    [[nodiscard]] std::size_t get_arena_size() const;
+};
+
+#endif // FRAME_ARENAS_H
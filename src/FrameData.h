@@ -0,0 +1,45 @@
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+#include <cstddef>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Uniform blocks shared by all shaders. Both mirror their std140 counterparts in the shaders, so
+// every vec3 is followed by a scalar that fills the rest of its 16 byte slot.
+
+constexpr GLuint FRAME_DATA_BINDING = 0;
+constexpr GLuint SUN_DATA_BINDING = 1;
+
+struct FrameData
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 camera_position;
+    float padding;
+};
+static_assert(offsetof(FrameData, view) == 0);
+static_assert(offsetof(FrameData, projection) == 64);
+static_assert(offsetof(FrameData, camera_position) == 128);
+static_assert(sizeof(FrameData) == 144);
+
+struct SunData
+{
+    glm::mat4 light_space;
+    glm::vec3 direction;
+    float diffuse;
+    glm::vec3 color;
+    float specular;
+    glm::vec3 ambient;
+    float padding;
+};
+static_assert(offsetof(SunData, light_space) == 0);
+static_assert(offsetof(SunData, direction) == 64);
+static_assert(offsetof(SunData, diffuse) == 76);
+static_assert(offsetof(SunData, color) == 80);
+static_assert(offsetof(SunData, specular) == 92);
+static_assert(offsetof(SunData, ambient) == 96);
+static_assert(sizeof(SunData) == 112);
+
+#endif // FRAME_DATA_H
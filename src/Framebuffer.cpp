@@ -2,14 +2,10 @@
 
 #include <stdexcept>
 
-Framebuffer::Framebuffer()
-{
-    glGenFramebuffers(1, &m_framebuffer);
-}
+#include "GLState.h"
 
-Framebuffer::~Framebuffer()
+Framebuffer::Framebuffer() : m_framebuffer(FramebufferObject::create())
 {
-    glDeleteFramebuffers(1, &m_framebuffer);
 }
 
 void Framebuffer::set_color_attachment(const Texture &texture, const GLenum attachment)
@@ -28,42 +24,40 @@ void Framebuffer::set_depth_attachment(const Texture &texture)
 
 void Framebuffer::set_draw_buffers(const std::span<const GLenum> attachments)
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
-    glDrawBuffers(attachments.size(), attachments.data());
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glNamedFramebufferDrawBuffers(m_framebuffer.get(), attachments.size(), attachments.data());
+    m_complete = false;
 }
 
 void Framebuffer::set_draw_buffer(const GLenum mode)
 {
-    // TODO - Use DSA
-    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
-    glDrawBuffer(mode);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glNamedFramebufferDrawBuffer(m_framebuffer.get(), mode);
+    m_complete = false;
 }
 
 void Framebuffer::set_read_buffer(const GLenum mode)
 {
-    // TODO - Use DSA
-    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
-    glReadBuffer(mode);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glNamedFramebufferReadBuffer(m_framebuffer.get(), mode);
+    m_complete = false;
 }
 
 void Framebuffer::bind()
 {
-    if (glCheckNamedFramebufferStatus(m_framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    // Completeness only changes with the attachments, so it is checked once after a change instead
+    // of on every bind.
+    if (!m_complete)
     {
-        throw std::runtime_error("Framebuffer incomplete");
+        const auto status = glCheckNamedFramebufferStatus(m_framebuffer.get(), GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE)
+        {
+            throw std::runtime_error("Framebuffer incomplete");
+        }
+        m_complete = true;
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    GLState::get().bind_framebuffer(m_framebuffer.get());
 }
 
 void Framebuffer::set_attachment(const Texture &texture, const GLenum attachment)
 {
-    // TODO - Use DSA
-    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture.get_handle(), 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    // glNamedFramebufferTexture(m_framebuffer, attachment, texture.get_handle(), 0);
+    glNamedFramebufferTexture(m_framebuffer.get(), attachment, texture.get_handle(), 0);
+    m_complete = false;
 }
@@ -5,17 +5,20 @@
 
 #include <glad/glad.h>
 
+#include "GLObject.h"
 #include "Texture.h"
 
 class Framebuffer
 {
-    GLuint m_framebuffer;
+    FramebufferObject m_framebuffer;
+    bool m_complete{false};
 
   public:
     explicit Framebuffer();
     Framebuffer(const Framebuffer &) = delete;
     const Framebuffer &operator=(const Framebuffer &) = delete;
-    ~Framebuffer();
+    Framebuffer(Framebuffer &&) = default;
+    Framebuffer &operator=(Framebuffer &&) = default;
 
     void set_color_attachment(const Texture &texture, GLenum attachment = GL_COLOR_ATTACHMENT0);
     void set_depth_attachment(const Texture &texture);
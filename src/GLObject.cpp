@@ -0,0 +1,149 @@
+#include "GLObject.h"
+
+#include <utility>
+
+#include "GLState.h"
+
+namespace
+{
+GLuint create_object(const GLObjectType type, const GLenum target)
+{
+    GLuint name = 0;
+    switch (type)
+    {
+        case GLObjectType::Buffer:
+            glCreateBuffers(1, &name);
+            break;
+        case GLObjectType::Texture:
+            glCreateTextures(target, 1, &name);
+            break;
+        case GLObjectType::VertexArray:
+            glCreateVertexArrays(1, &name);
+            break;
+        case GLObjectType::Framebuffer:
+            glCreateFramebuffers(1, &name);
+            break;
+        case GLObjectType::Query:
+            glCreateQueries(target, 1, &name);
+            break;
+        case GLObjectType::Program:
+            name = glCreateProgram();
+            break;
+        case GLObjectType::Shader:
+            name = glCreateShader(target);
+            break;
+    }
+    return name;
+}
+
+// Deleted names may be reused, so the shadowed bindings of GLState are forgotten first.
+void delete_object(const GLObjectType type, const GLuint name)
+{
+    auto &gl_state = GLState::get();
+    switch (type)
+    {
+        case GLObjectType::Buffer:
+            gl_state.forget_buffer(name);
+            glDeleteBuffers(1, &name);
+            break;
+        case GLObjectType::Texture:
+            gl_state.forget_texture(name);
+            glDeleteTextures(1, &name);
+            break;
+        case GLObjectType::VertexArray:
+            gl_state.forget_vertex_array(name);
+            glDeleteVertexArrays(1, &name);
+            break;
+        case GLObjectType::Framebuffer:
+            gl_state.forget_framebuffer(name);
+            glDeleteFramebuffers(1, &name);
+            break;
+        case GLObjectType::Query:
+            glDeleteQueries(1, &name);
+            break;
+        case GLObjectType::Program:
+            gl_state.forget_program(name);
+            glDeleteProgram(name);
+            break;
+        case GLObjectType::Shader:
+            glDeleteShader(name);
+            break;
+    }
+}
+} // namespace
+
+template <GLObjectType Type> GLObject<Type>::GLObject(const GLuint name) : m_name(name)
+{
+    if (m_name != 0)
+    {
+        GLObjectRegistry::get().add(Type);
+    }
+}
+
+template <GLObjectType Type> GLObject<Type> GLObject<Type>::create(const GLenum target)
+{
+    return GLObject(create_object(Type, target));
+}
+
+template <GLObjectType Type>
+GLObject<Type>::GLObject(GLObject &&other) noexcept
+    : m_name(std::exchange(other.m_name, 0)), m_size(std::exchange(other.m_size, 0))
+{
+}
+
+template <GLObjectType Type> GLObject<Type> &GLObject<Type>::operator=(GLObject &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        m_name = std::exchange(other.m_name, 0);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+template <GLObjectType Type> GLObject<Type>::~GLObject()
+{
+    reset();
+}
+
+template <GLObjectType Type> void GLObject<Type>::reset()
+{
+    if (m_name == 0)
+    {
+        return;
+    }
+    delete_object(Type, m_name);
+    GLObjectRegistry::get().remove(Type, m_size);
+    m_name = 0;
+    m_size = 0;
+}
+
+template <GLObjectType Type> void GLObject<Type>::set_size(const GLsizeiptr size)
+{
+    GLObjectRegistry::get().resize(Type, m_size, size);
+    m_size = size;
+}
+
+template <GLObjectType Type> GLuint GLObject<Type>::get() const
+{
+    return m_name;
+}
+
+template <GLObjectType Type> GLsizeiptr GLObject<Type>::get_size() const
+{
+    return m_size;
+}
+
+template <GLObjectType Type> GLObject<Type>::operator bool() const
+{
+    return m_name != 0;
+}
+
+template class GLObject<GLObjectType::Buffer>;
+template class GLObject<GLObjectType::Texture>;
+template class GLObject<GLObjectType::VertexArray>;
+template class GLObject<GLObjectType::Framebuffer>;
+template class GLObject<GLObjectType::Query>;
+template class GLObject<GLObjectType::Program>;
+template class GLObject<GLObjectType::Shader>;
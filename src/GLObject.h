@@ -0,0 +1,56 @@
+#ifndef GL_OBJECT_H
+#define GL_OBJECT_H
+
+#include <glad/glad.h>
+
+#include "GLObjectRegistry.h"
+
+// Owns the name of a GL object and deletes it when destroyed. Objects can be moved but not
+// copied, and every live object is counted in the GLObjectRegistry.
+template <GLObjectType Type> class GLObject
+{
+    GLuint m_name{};
+    GLsizeiptr m_size{};
+
+    explicit GLObject(GLuint name);
+
+  public:
+    // An empty object that owns nothing.
+    GLObject() = default;
+    // Creates an object with the direct state access function of its type. `target` is the
+    // texture target, the query target or the shader type, and is ignored by the other types.
+    [[nodiscard]] static GLObject create(GLenum target = GL_NONE);
+
+    GLObject(const GLObject &) = delete;
+    const GLObject &operator=(const GLObject &) = delete;
+    GLObject(GLObject &&other) noexcept;
+    GLObject &operator=(GLObject &&other) noexcept;
+    ~GLObject();
+
+    // Deletes the object, leaving this one empty.
+    void reset();
+    // Records the bytes of storage the object holds, for the registry.
+    void set_size(GLsizeiptr size);
+
+    [[nodiscard]] GLuint get() const;
+    [[nodiscard]] GLsizeiptr get_size() const;
+    explicit operator bool() const;
+};
+
+extern template class GLObject<GLObjectType::Buffer>;
+extern template class GLObject<GLObjectType::Texture>;
+extern template class GLObject<GLObjectType::VertexArray>;
+extern template class GLObject<GLObjectType::Framebuffer>;
+extern template class GLObject<GLObjectType::Query>;
+extern template class GLObject<GLObjectType::Program>;
+extern template class GLObject<GLObjectType::Shader>;
+
+using BufferObject = GLObject<GLObjectType::Buffer>;
+using TextureObject = GLObject<GLObjectType::Texture>;
+using VertexArrayObject = GLObject<GLObjectType::VertexArray>;
+using FramebufferObject = GLObject<GLObjectType::Framebuffer>;
+using QueryObject = GLObject<GLObjectType::Query>;
+using ProgramObject = GLObject<GLObjectType::Program>;
+using ShaderObject = GLObject<GLObjectType::Shader>;
+
+#endif // GL_OBJECT_H
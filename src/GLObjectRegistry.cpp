@@ -0,0 +1,78 @@
+#include "GLObjectRegistry.h"
+
+#include <spdlog/spdlog.h>
+
+GLObjectRegistry &GLObjectRegistry::get()
+{
+    static GLObjectRegistry registry;
+    return registry;
+}
+
+const char *GLObjectRegistry::get_type_name(const GLObjectType type)
+{
+    switch (type)
+    {
+        case GLObjectType::Buffer:
+            return "buffer";
+        case GLObjectType::Texture:
+            return "texture";
+        case GLObjectType::VertexArray:
+            return "vertex array";
+        case GLObjectType::Framebuffer:
+            return "framebuffer";
+        case GLObjectType::Query:
+            return "query";
+        case GLObjectType::Program:
+            return "program";
+        case GLObjectType::Shader:
+            return "shader";
+    }
+    return "unknown";
+}
+
+void GLObjectRegistry::add(const GLObjectType type)
+{
+    auto &entry = m_entries[static_cast<std::size_t>(type)];
+    ++entry.live;
+    ++entry.created;
+}
+
+void GLObjectRegistry::remove(const GLObjectType type, const GLsizeiptr size)
+{
+    auto &entry = m_entries[static_cast<std::size_t>(type)];
+    --entry.live;
+    entry.bytes -= size;
+}
+
+void GLObjectRegistry::resize(
+    const GLObjectType type, const GLsizeiptr old_size, const GLsizeiptr new_size
+)
+{
+    m_entries[static_cast<std::size_t>(type)].bytes += new_size - old_size;
+}
+
+const GLObjectRegistry::Entry &GLObjectRegistry::get_entry(const GLObjectType type) const
+{
+    return m_entries[static_cast<std::size_t>(type)];
+}
+
+bool GLObjectRegistry::report_leaks() const
+{
+    auto leaked = false;
+    for (std::size_t i = 0; i < m_entries.size(); ++i)
+    {
+        const auto &entry = m_entries[i];
+        if (entry.live != 0)
+        {
+            spdlog::warn(
+                "{} {} objects ({} bytes) of {} created were not deleted",
+                entry.live,
+                get_type_name(static_cast<GLObjectType>(i)),
+                entry.bytes,
+                entry.created
+            );
+            leaked = true;
+        }
+    }
+    return leaked;
+}
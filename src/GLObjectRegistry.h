@@ -0,0 +1,55 @@
+#ifndef GL_OBJECT_REGISTRY_H
+#define GL_OBJECT_REGISTRY_H
+
+#include <array>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+enum class GLObjectType : std::uint8_t
+{
+    Buffer,
+    Texture,
+    VertexArray,
+    Framebuffer,
+    Query,
+    Program,
+    Shader,
+};
+
+// Counts the GL objects that are alive and the memory they hold, so that objects that are never
+// deleted show up instead of piling up over scene reloads.
+class GLObjectRegistry
+{
+  public:
+    static constexpr std::size_t TYPE_COUNT = 7;
+
+    struct Entry
+    {
+        std::int64_t live{};
+        std::int64_t bytes{};
+        std::uint64_t created{};
+    };
+
+  private:
+    std::array<Entry, TYPE_COUNT> m_entries{};
+
+    explicit GLObjectRegistry() = default;
+
+  public:
+    GLObjectRegistry(const GLObjectRegistry &) = delete;
+    const GLObjectRegistry &operator=(const GLObjectRegistry &) = delete;
+
+    static GLObjectRegistry &get();
+    [[nodiscard]] static const char *get_type_name(GLObjectType type);
+
+    void add(GLObjectType type);
+    void remove(GLObjectType type, GLsizeiptr size);
+    void resize(GLObjectType type, GLsizeiptr old_size, GLsizeiptr new_size);
+
+    [[nodiscard]] const Entry &get_entry(GLObjectType type) const;
+    // Logs the objects that are still alive. Returns whether there were any.
+    bool report_leaks() const;
+};
+
+#endif // GL_OBJECT_REGISTRY_H
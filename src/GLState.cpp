@@ -0,0 +1,359 @@
+#include "GLState.h"
+
+#include <algorithm>
+
+namespace
+{
+std::size_t capability_index(const GLenum capability)
+{
+    switch (capability)
+    {
+        case GL_DEPTH_TEST:
+            return 0;
+        case GL_CULL_FACE:
+            return 1;
+        case GL_BLEND:
+            return 2;
+        case GL_SCISSOR_TEST:
+            return 3;
+        default:
+            return ~std::size_t{0};
+    }
+}
+
+std::size_t texture_target_index(const GLenum target)
+{
+    switch (target)
+    {
+        case GL_TEXTURE_2D:
+            return 0;
+        case GL_TEXTURE_CUBE_MAP:
+            return 1;
+        default:
+            return ~std::size_t{0};
+    }
+}
+
+std::size_t indexed_target_index(const GLenum target)
+{
+    switch (target)
+    {
+        case GL_SHADER_STORAGE_BUFFER:
+            return 0;
+        case GL_UNIFORM_BUFFER:
+            return 1;
+        default:
+            return ~std::size_t{0};
+    }
+}
+} // namespace
+
+GLState::GLState()
+{
+    invalidate();
+}
+
+GLState &GLState::get()
+{
+    static GLState state;
+    return state;
+}
+
+void GLState::use_program(const GLuint program)
+{
+    if (filter(m_program == program))
+    {
+        return;
+    }
+    m_program = program;
+    glUseProgram(program);
+}
+
+void GLState::bind_vertex_array(const GLuint vertex_array)
+{
+    if (filter(m_vertex_array == vertex_array))
+    {
+        return;
+    }
+    m_vertex_array = vertex_array;
+    glBindVertexArray(vertex_array);
+}
+
+void GLState::bind_framebuffer(const GLuint framebuffer)
+{
+    if (filter(m_framebuffer == framebuffer))
+    {
+        return;
+    }
+    m_framebuffer = framebuffer;
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void GLState::bind_texture(const GLuint unit, const GLenum target, const GLuint texture)
+{
+    const auto target_index = texture_target_index(target);
+    if (unit >= MAX_TEXTURE_UNITS || target_index == ~std::size_t{0})
+    {
+        filter(false);
+        glBindTextureUnit(unit, texture);
+        return;
+    }
+
+    auto &bound = m_textures[unit][target_index];
+    if (filter(bound == texture))
+    {
+        return;
+    }
+    bound = texture;
+    glBindTextureUnit(unit, texture);
+}
+
+void GLState::bind_buffer(const GLenum target, const GLuint buffer)
+{
+    GLuint *bound = nullptr;
+    if (target == GL_DRAW_INDIRECT_BUFFER)
+    {
+        bound = &m_draw_indirect_buffer;
+    }
+    else if (target == GL_PARAMETER_BUFFER)
+    {
+        bound = &m_parameter_buffer;
+    }
+
+    if (bound)
+    {
+        if (filter(*bound == buffer))
+        {
+            return;
+        }
+        *bound = buffer;
+    }
+    else
+    {
+        filter(false);
+    }
+    glBindBuffer(target, buffer);
+}
+
+void GLState::bind_buffer_base(const GLenum target, const GLuint index, const GLuint buffer)
+{
+    if (filter_indexed(target, index, IndexedBinding{.buffer = buffer, .offset = 0, .size = 0}))
+    {
+        return;
+    }
+    glBindBufferBase(target, index, buffer);
+}
+
+void GLState::bind_buffer_range(
+    const GLenum target, const GLuint index, const GLuint buffer, const GLintptr offset,
+    const GLsizeiptr size
+)
+{
+    if (filter_indexed(
+            target,
+            index,
+            IndexedBinding{.buffer = buffer, .offset = offset, .size = size}
+        ))
+    {
+        return;
+    }
+    glBindBufferRange(target, index, buffer, offset, size);
+}
+
+void GLState::set_enabled(const GLenum capability, const bool enabled)
+{
+    const auto index = capability_index(capability);
+    if (index != ~std::size_t{0})
+    {
+        const GLuint value = enabled ? GL_TRUE : GL_FALSE;
+        if (filter(m_capabilities[index] == value))
+        {
+            return;
+        }
+        m_capabilities[index] = value;
+    }
+    else
+    {
+        filter(false);
+    }
+
+    if (enabled)
+    {
+        glEnable(capability);
+    }
+    else
+    {
+        glDisable(capability);
+    }
+}
+
+void GLState::enable(const GLenum capability)
+{
+    set_enabled(capability, true);
+}
+
+void GLState::disable(const GLenum capability)
+{
+    set_enabled(capability, false);
+}
+
+void GLState::depth_func(const GLenum func)
+{
+    if (filter(m_depth_func == func))
+    {
+        return;
+    }
+    m_depth_func = func;
+    glDepthFunc(func);
+}
+
+void GLState::depth_mask(const GLboolean mask)
+{
+    if (filter(m_depth_mask == mask))
+    {
+        return;
+    }
+    m_depth_mask = mask;
+    glDepthMask(mask);
+}
+
+void GLState::viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height)
+{
+    const std::array<GLint, 4> viewport{x, y, width, height};
+    if (filter(m_viewport_known && m_viewport == viewport))
+    {
+        return;
+    }
+    m_viewport = viewport;
+    m_viewport_known = true;
+    glViewport(x, y, width, height);
+}
+
+void GLState::invalidate()
+{
+    m_program = UNKNOWN;
+    m_vertex_array = UNKNOWN;
+    m_framebuffer = UNKNOWN;
+    m_draw_indirect_buffer = UNKNOWN;
+    m_parameter_buffer = UNKNOWN;
+    for (auto &unit : m_textures)
+    {
+        unit.fill(UNKNOWN);
+    }
+    for (auto &target : m_indexed_buffers)
+    {
+        target.fill(IndexedBinding{.buffer = UNKNOWN, .offset = 0, .size = 0});
+    }
+    m_capabilities.fill(UNKNOWN);
+    m_depth_func = UNKNOWN;
+    m_depth_mask = UNKNOWN;
+    m_viewport_known = false;
+}
+
+void GLState::forget_program(const GLuint program)
+{
+    if (m_program == program)
+    {
+        m_program = UNKNOWN;
+    }
+}
+
+void GLState::forget_vertex_array(const GLuint vertex_array)
+{
+    if (m_vertex_array == vertex_array)
+    {
+        m_vertex_array = UNKNOWN;
+    }
+}
+
+void GLState::forget_framebuffer(const GLuint framebuffer)
+{
+    if (m_framebuffer == framebuffer)
+    {
+        m_framebuffer = UNKNOWN;
+    }
+}
+
+void GLState::forget_texture(const GLuint texture)
+{
+    for (auto &unit : m_textures)
+    {
+        std::ranges::replace(unit, texture, UNKNOWN);
+    }
+}
+
+void GLState::forget_buffer(const GLuint buffer)
+{
+    if (m_draw_indirect_buffer == buffer)
+    {
+        m_draw_indirect_buffer = UNKNOWN;
+    }
+    if (m_parameter_buffer == buffer)
+    {
+        m_parameter_buffer = UNKNOWN;
+    }
+    for (auto &target : m_indexed_buffers)
+    {
+        for (auto &binding : target)
+        {
+            if (binding.buffer == buffer)
+            {
+                binding.buffer = UNKNOWN;
+            }
+        }
+    }
+}
+
+void GLState::set_filtering(const bool filtering)
+{
+    m_filtering = filtering;
+}
+
+bool GLState::is_filtering() const
+{
+    return m_filtering;
+}
+
+void GLState::end_frame()
+{
+    m_last_frame_stats = m_stats;
+    m_stats = {};
+}
+
+const GLState::Stats &GLState::get_stats() const
+{
+    return m_last_frame_stats;
+}
+
+bool GLState::filter_indexed(
+    const GLenum target, const GLuint index, const IndexedBinding &binding
+)
+{
+    const auto target_index = indexed_target_index(target);
+    if (index >= MAX_BUFFER_BINDINGS || target_index == ~std::size_t{0})
+    {
+        return filter(false);
+    }
+
+    auto &bound = m_indexed_buffers[target_index][index];
+    if (filter(bound == binding))
+    {
+        return true;
+    }
+    bound = binding;
+    return false;
+}
+
+bool GLState::filter(const bool redundant)
+{
+    if (redundant)
+    {
+        ++m_stats.redundant;
+        if (m_filtering)
+        {
+            return true;
+        }
+    }
+    ++m_stats.issued;
+    return false;
+}
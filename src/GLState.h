@@ -0,0 +1,127 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <array>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+// Shadow copy of the GL state that the renderer changes frequently. Every change goes through
+// here so that redundant driver calls are filtered out. Code that changes GL state behind the
+// tracker's back (e.g. the ImGui backend) must be followed by `invalidate`.
+class GLState
+{
+  public:
+    static constexpr GLuint MAX_TEXTURE_UNITS = 16;
+    static constexpr GLuint MAX_BUFFER_BINDINGS = 16;
+
+    struct Stats
+    {
+        // Calls that reached the driver.
+        std::uint64_t issued{};
+        // Calls that would not have changed anything. They are skipped while filtering is enabled.
+        std::uint64_t redundant{};
+    };
+
+  private:
+    enum class Capability
+    {
+        DepthTest,
+        CullFace,
+        Blend,
+        ScissorTest,
+        Count,
+    };
+
+    enum class TextureTarget
+    {
+        Texture2D,
+        CubeMap,
+        Count,
+    };
+
+    enum class IndexedTarget
+    {
+        ShaderStorage,
+        Uniform,
+        Count,
+    };
+
+    // A value of `UNKNOWN` forces the next change to be issued.
+    static constexpr GLuint UNKNOWN = ~0u;
+
+    GLuint m_program{UNKNOWN};
+    GLuint m_vertex_array{UNKNOWN};
+    GLuint m_framebuffer{UNKNOWN};
+    GLuint m_draw_indirect_buffer{UNKNOWN};
+    GLuint m_parameter_buffer{UNKNOWN};
+    using TextureUnit = std::array<GLuint, static_cast<std::size_t>(TextureTarget::Count)>;
+    struct IndexedBinding
+    {
+        GLuint buffer;
+        GLintptr offset;
+        // Zero when the whole buffer is bound.
+        GLsizeiptr size;
+
+        bool operator==(const IndexedBinding &) const = default;
+    };
+    using BufferBindings = std::array<IndexedBinding, MAX_BUFFER_BINDINGS>;
+
+    std::array<TextureUnit, MAX_TEXTURE_UNITS> m_textures{};
+    std::array<BufferBindings, static_cast<std::size_t>(IndexedTarget::Count)> m_indexed_buffers{};
+    std::array<GLuint, static_cast<std::size_t>(Capability::Count)> m_capabilities{};
+    GLuint m_depth_func{UNKNOWN};
+    GLuint m_depth_mask{UNKNOWN};
+    std::array<GLint, 4> m_viewport{};
+    bool m_viewport_known{false};
+
+    bool m_filtering{true};
+    Stats m_stats;
+    Stats m_last_frame_stats;
+
+    explicit GLState();
+
+  public:
+    GLState(const GLState &) = delete;
+    const GLState &operator=(const GLState &) = delete;
+
+    static GLState &get();
+
+    void use_program(GLuint program);
+    void bind_vertex_array(GLuint vertex_array);
+    void bind_framebuffer(GLuint framebuffer);
+    void bind_texture(GLuint unit, GLenum target, GLuint texture);
+    void bind_buffer(GLenum target, GLuint buffer);
+    void bind_buffer_base(GLenum target, GLuint index, GLuint buffer);
+    void bind_buffer_range(
+        GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size
+    );
+
+    void set_enabled(GLenum capability, bool enabled);
+    void enable(GLenum capability);
+    void disable(GLenum capability);
+    void depth_func(GLenum func);
+    void depth_mask(GLboolean mask);
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // Forgets the shadowed state so that the next change of everything is issued.
+    void invalidate();
+    // Called when a GL object is deleted, since its name may be reused.
+    void forget_program(GLuint program);
+    void forget_vertex_array(GLuint vertex_array);
+    void forget_framebuffer(GLuint framebuffer);
+    void forget_texture(GLuint texture);
+    void forget_buffer(GLuint buffer);
+
+    void set_filtering(bool filtering);
+    [[nodiscard]] bool is_filtering() const;
+
+    void end_frame();
+    [[nodiscard]] const Stats &get_stats() const;
+
+  private:
+    bool filter(bool redundant);
+    bool filter_indexed(GLenum target, GLuint index, const IndexedBinding &binding);
+};
+
+#endif // GL_STATE_H
@@ -0,0 +1,293 @@
+#include "GpuCulling.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "GLState.h"
+
+namespace
+{
+constexpr GLuint CULL_GROUP_SIZE = 64;
+// The smallest GL_MAX_COMPUTE_WORK_GROUP_COUNT allowed.
+constexpr GLuint MAX_GROUP_COUNT = 65535;
+constexpr GLuint PYRAMID_GROUP_SIZE = 8;
+
+std::array<glm::vec4, 6> extract_frustum_planes(const glm::mat4 &m)
+{
+    const auto row = [&m](const int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+
+    std::array<glm::vec4, 6> planes{
+        row(3) + row(0),
+        row(3) - row(0),
+        row(3) + row(1),
+        row(3) - row(1),
+        row(3) + row(2),
+        row(3) - row(2),
+    };
+    for (auto &plane : planes)
+    {
+        plane = plane / glm::length(glm::vec3(plane));
+    }
+    return planes;
+}
+
+int previous_power_of_two(const int value)
+{
+    return static_cast<int>(std::bit_floor(static_cast<unsigned int>(value)));
+}
+
+std::size_t get_max_commands(const SceneGeometry &geometry)
+{
+    return std::max(geometry.get_draw_count(), geometry.get_meshlet_command_count());
+}
+} // namespace
+
+GpuCulling::GpuCulling(const SceneGeometry &geometry, const int width, const int height)
+    : m_geometry(geometry), m_compact(glMultiDrawElementsIndirectCount != nullptr),
+      m_views{
+          ViewBuffers{
+              Buffer(get_max_commands(geometry) * sizeof(DrawElementsIndirectCommand)),
+              Buffer(get_max_commands(geometry) * sizeof(GLuint)),
+              Buffer(geometry.get_batch_sizes().size() * sizeof(GLuint)),
+          },
+          ViewBuffers{
+              Buffer(get_max_commands(geometry) * sizeof(DrawElementsIndirectCommand)),
+              Buffer(get_max_commands(geometry) * sizeof(GLuint)),
+              Buffer(geometry.get_batch_sizes().size() * sizeof(GLuint)),
+          },
+      },
+      m_pyramid_width(previous_power_of_two(width)),
+      m_pyramid_height(previous_power_of_two(height)),
+      m_pyramid_levels(std::bit_width(
+          static_cast<unsigned int>(std::max(m_pyramid_width, m_pyramid_height))
+      )),
+      m_depth_pyramid(Texture::depth_pyramid(m_pyramid_width, m_pyramid_height, m_pyramid_levels))
+{
+    m_cull_program.attach_shader(GL_COMPUTE_SHADER, "./shaders/cull.comp.glsl");
+    m_cull_program.link();
+    m_cull_uniforms.item_count = m_cull_program.get_uniform<GLuint>("item_count");
+    m_cull_uniforms.active_draw_count = m_cull_program.get_uniform<GLuint>("active_draw_count");
+    m_cull_uniforms.cull_meshlets = m_cull_program.get_uniform<bool>("cull_meshlets");
+    m_cull_uniforms.cone_culling = m_cull_program.get_uniform<bool>("cone_culling");
+    m_cull_uniforms.viewer = m_cull_program.get_uniform<glm::vec4>("viewer");
+    m_cull_uniforms.lod_scale = m_cull_program.get_uniform<float>("lod_scale");
+    m_cull_uniforms.compact = m_cull_program.get_uniform<bool>("compact");
+    m_cull_uniforms.single_batch = m_cull_program.get_uniform<bool>("single_batch");
+    m_cull_uniforms.frustum_planes =
+        m_cull_program.get_uniform<std::span<const glm::vec4>>("frustum_planes");
+    m_cull_uniforms.occlusion_culling = m_cull_program.get_uniform<bool>("occlusion_culling");
+    m_cull_uniforms.previous_view_projection =
+        m_cull_program.get_uniform<glm::mat4>("previous_view_projection");
+    m_cull_uniforms.pyramid_size = m_cull_program.get_uniform<glm::vec2>("pyramid_size");
+    m_cull_uniforms.pyramid_levels = m_cull_program.get_uniform<int>("pyramid_levels");
+    m_cull_uniforms.depth_pyramid = m_cull_program.get_uniform<int>("depth_pyramid");
+
+    m_depth_pyramid_program.attach_shader(GL_COMPUTE_SHADER, "./shaders/depth_pyramid.comp.glsl");
+    m_depth_pyramid_program.link();
+    m_depth_pyramid_uniforms.source = m_depth_pyramid_program.get_uniform<int>("source");
+    m_depth_pyramid_uniforms.source_level =
+        m_depth_pyramid_program.get_uniform<int>("source_level");
+}
+
+void GpuCulling::cull(
+    const View view, const glm::mat4 &view_projection, const glm::vec4 &viewer,
+    const float lod_scale, const bool occlusion_culling
+)
+{
+    auto &buffers = get_view_buffers(view);
+    buffers.m_counts.clear(0, buffers.m_counts.get_size());
+
+    m_geometry.bind();
+    if (m_meshlet_culling)
+    {
+        m_geometry.bind_meshlets();
+    }
+    buffers.m_commands.bind_base(GL_SHADER_STORAGE_BUFFER, DRAW_COMMAND_BINDING);
+    buffers.m_draw_ids.bind_base(GL_SHADER_STORAGE_BUFFER, SceneGeometry::DRAW_ID_BINDING);
+    buffers.m_counts.bind_base(GL_SHADER_STORAGE_BUFFER, DRAW_COUNT_BINDING);
+
+    const auto count = m_geometry.get_draw_count();
+    m_cull_program.use();
+    m_cull_program.set_uniform(m_cull_uniforms.item_count, count);
+    m_cull_program.set_uniform(
+        m_cull_uniforms.active_draw_count,
+        m_geometry.get_active_draw_count()
+    );
+    m_cull_program.set_uniform(m_cull_uniforms.cull_meshlets, m_meshlet_culling);
+    m_cull_program.set_uniform(m_cull_uniforms.cone_culling, m_meshlet_culling && m_cone_culling);
+    m_cull_program.set_uniform(m_cull_uniforms.viewer, viewer);
+    m_cull_program.set_uniform(m_cull_uniforms.lod_scale, lod_scale);
+    m_cull_program.set_uniform(m_cull_uniforms.compact, m_compact);
+    m_cull_program.set_uniform(m_cull_uniforms.single_batch, view == View::Shadow);
+    const auto frustum_planes = extract_frustum_planes(view_projection);
+    m_cull_program.set_uniform(m_cull_uniforms.frustum_planes, frustum_planes);
+
+    const auto use_pyramid = occlusion_culling && view == View::Camera && m_pyramid_valid;
+    m_cull_program.set_uniform(m_cull_uniforms.occlusion_culling, use_pyramid);
+    m_cull_program.set_uniform(
+        m_cull_uniforms.previous_view_projection,
+        m_pyramid_view_projection
+    );
+    m_cull_program.set_uniform(
+        m_cull_uniforms.pyramid_size,
+        glm::vec2(static_cast<float>(m_pyramid_width), static_cast<float>(m_pyramid_height))
+    );
+    m_cull_program.set_uniform(m_cull_uniforms.pyramid_levels, m_pyramid_levels);
+    m_cull_program.set_uniform(m_cull_uniforms.depth_pyramid, 0);
+    m_depth_pyramid.bind(GL_TEXTURE0);
+
+    // One work group per draw when culling meshlets, split into rows if there are more than
+    // every implementation supports in one dimension.
+    const auto groups =
+        m_meshlet_culling ? count : (count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+    const auto columns = std::min(groups, MAX_GROUP_COUNT);
+    glDispatchCompute(columns, (groups + columns - 1) / std::max(columns, 1u), 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void GpuCulling::draw(const View view, const std::span<const MaterialTextures> materials)
+{
+    auto &buffers = get_view_buffers(view);
+
+    m_geometry.bind(
+        view == View::Shadow ? SceneGeometry::VertexStream::PositionOnly
+                             : SceneGeometry::VertexStream::Full
+    );
+    buffers.m_commands.bind(GL_DRAW_INDIRECT_BUFFER);
+    buffers.m_counts.bind(GL_PARAMETER_BUFFER);
+    buffers.m_draw_ids.bind_base(GL_SHADER_STORAGE_BUFFER, SceneGeometry::DRAW_ID_BINDING);
+
+    const auto draw_batch = [&](const GLuint batch, const GLuint offset, const GLuint size) {
+        const auto *indirect = reinterpret_cast<const void *>(
+            static_cast<std::uintptr_t>(offset * sizeof(DrawElementsIndirectCommand))
+        );
+        if (m_compact)
+        {
+            glMultiDrawElementsIndirectCount(
+                GL_TRIANGLES,
+                m_geometry.get_index_type(),
+                indirect,
+                static_cast<GLintptr>(batch * sizeof(GLuint)),
+                static_cast<GLsizei>(size),
+                0
+            );
+        }
+        else
+        {
+            glMultiDrawElementsIndirect(
+                GL_TRIANGLES,
+                m_geometry.get_index_type(),
+                indirect,
+                static_cast<GLsizei>(size),
+                0
+            );
+        }
+    };
+
+    if (view == View::Shadow)
+    {
+        draw_batch(
+            0,
+            0,
+            m_meshlet_culling ? m_geometry.get_meshlet_command_count()
+                              : m_geometry.get_draw_count()
+        );
+    }
+    else
+    {
+        const auto offsets = m_meshlet_culling ? m_geometry.get_meshlet_batch_offsets()
+                                               : m_geometry.get_batch_offsets();
+        const auto sizes = m_meshlet_culling ? m_geometry.get_meshlet_batch_sizes()
+                                             : m_geometry.get_batch_sizes();
+        for (GLuint batch = 0; batch < sizes.size(); ++batch)
+        {
+            if (sizes[batch] == 0)
+            {
+                continue;
+            }
+            GLState::get().bind_texture(0, GL_TEXTURE_2D, materials[batch].diffuse);
+            GLState::get().bind_texture(1, GL_TEXTURE_2D, materials[batch].normal);
+            draw_batch(batch, offsets[batch], sizes[batch]);
+        }
+    }
+}
+
+void GpuCulling::build_depth_pyramid(const Texture &depth, const glm::mat4 &view_projection)
+{
+    m_depth_pyramid_program.use();
+    m_depth_pyramid_program.set_uniform(m_depth_pyramid_uniforms.source, 0);
+
+    for (auto level = 0; level < m_pyramid_levels; ++level)
+    {
+        if (level == 0)
+        {
+            GLState::get().bind_texture(0, GL_TEXTURE_2D, depth.get_handle());
+            m_depth_pyramid_program.set_uniform(m_depth_pyramid_uniforms.source_level, 0);
+        }
+        else
+        {
+            GLState::get().bind_texture(0, GL_TEXTURE_2D, m_depth_pyramid.get_handle());
+            m_depth_pyramid_program.set_uniform(
+                m_depth_pyramid_uniforms.source_level,
+                level - 1
+            );
+        }
+        glBindImageTexture(
+            0,
+            m_depth_pyramid.get_handle(),
+            level,
+            GL_FALSE,
+            0,
+            GL_WRITE_ONLY,
+            GL_R32F
+        );
+
+        const auto width = std::max(m_pyramid_width >> level, 1);
+        const auto height = std::max(m_pyramid_height >> level, 1);
+        glDispatchCompute(
+            (width + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE,
+            (height + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE,
+            1
+        );
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+
+    m_pyramid_view_projection = view_projection;
+    m_pyramid_valid = true;
+}
+
+void GpuCulling::invalidate_depth_pyramid()
+{
+    m_pyramid_valid = false;
+}
+
+void GpuCulling::set_meshlet_culling(const bool enabled)
+{
+    m_meshlet_culling = enabled;
+}
+
+void GpuCulling::set_cone_culling(const bool enabled)
+{
+    m_cone_culling = enabled;
+}
+
+bool GpuCulling::is_compacting() const
+{
+    return m_compact;
+}
+
+std::array<ShaderProgram *, 2> GpuCulling::get_programs()
+{
+    return {&m_cull_program, &m_depth_pyramid_program};
+}
+
+const Texture &GpuCulling::get_depth_pyramid() const
+{
+    return m_depth_pyramid;
+}
+
+GpuCulling::ViewBuffers &GpuCulling::get_view_buffers(const View view)
+{
+    return m_views[static_cast<int>(view)];
+}
@@ -0,0 +1,107 @@
+#ifndef GPU_CULLING_H
+#define GPU_CULLING_H
+
+#include <array>
+#include <span>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Buffer.h"
+#include "Material.h"
+#include "SceneGeometry.h"
+#include "ShaderProgram.h"
+#include "Texture.h"
+
+// Frustum and Hi-Z occlusion culling in a compute shader. The surviving draws are written as
+// `DrawElementsIndirectCommand`s and consumed with `glMultiDrawElementsIndirectCount`, so the
+// CPU cost per frame only depends on the number of materials, not on the number of meshes.
+// With meshlet culling, every meshlet is culled on its own and additionally by its normal cone,
+// so that large meshes are drawn only in part. The level of detail of every draw is selected in
+// the same pass.
+class GpuCulling
+{
+  public:
+    enum class View
+    {
+        Shadow,
+        Camera,
+    };
+
+    static constexpr GLuint DRAW_COMMAND_BINDING = 1;
+    static constexpr GLuint DRAW_COUNT_BINDING = 3;
+
+  private:
+    struct ViewBuffers
+    {
+        Buffer m_commands;
+        Buffer m_draw_ids;
+        Buffer m_counts;
+    };
+
+    const SceneGeometry &m_geometry;
+    bool m_compact;
+    bool m_meshlet_culling{true};
+    bool m_cone_culling{true};
+
+    ShaderProgram m_cull_program;
+    struct
+    {
+        UniformHandle<GLuint> item_count;
+        UniformHandle<GLuint> active_draw_count;
+        UniformHandle<bool> cull_meshlets;
+        UniformHandle<bool> cone_culling;
+        UniformHandle<glm::vec4> viewer;
+        UniformHandle<float> lod_scale;
+        UniformHandle<bool> compact;
+        UniformHandle<bool> single_batch;
+        UniformHandle<std::span<const glm::vec4>> frustum_planes;
+        UniformHandle<bool> occlusion_culling;
+        UniformHandle<glm::mat4> previous_view_projection;
+        UniformHandle<glm::vec2> pyramid_size;
+        UniformHandle<int> pyramid_levels;
+        UniformHandle<int> depth_pyramid;
+    } m_cull_uniforms;
+    std::array<ViewBuffers, 2> m_views;
+
+    ShaderProgram m_depth_pyramid_program;
+    struct
+    {
+        UniformHandle<int> source;
+        UniformHandle<int> source_level;
+    } m_depth_pyramid_uniforms;
+    int m_pyramid_width;
+    int m_pyramid_height;
+    int m_pyramid_levels;
+    Texture m_depth_pyramid;
+    glm::mat4 m_pyramid_view_projection{1.0f};
+    bool m_pyramid_valid{false};
+
+  public:
+    explicit GpuCulling(const SceneGeometry &geometry, int width, int height);
+
+    // The viewer is the position of the camera with w = 1, or the direction of a directional
+    // view with w = 0, for cone culling and LOD selection. See SceneGeometry::select_lod for the
+    // LOD scale.
+    void cull(
+        View view, const glm::mat4 &view_projection, const glm::vec4 &viewer, float lod_scale,
+        bool occlusion_culling
+    );
+    // Draws with the program in use, which finds the draw of a command at its base instance.
+    void draw(View view, std::span<const MaterialTextures> materials);
+
+    void build_depth_pyramid(const Texture &depth, const glm::mat4 &view_projection);
+    void invalidate_depth_pyramid();
+
+    void set_meshlet_culling(bool enabled);
+    void set_cone_culling(bool enabled);
+
+    [[nodiscard]] bool is_compacting() const;
+    [[nodiscard]] const Texture &get_depth_pyramid() const;
+    [[nodiscard]] std::array<ShaderProgram *, 2> get_programs();
+
+  private:
+    ViewBuffers &get_view_buffers(View view);
+};
+
+#endif // GPU_CULLING_H
@@ -0,0 +1,54 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer()
+{
+    for (auto &query : m_queries)
+    {
+        query = QueryObject::create(GL_TIME_ELAPSED);
+    }
+}
+
+void GpuTimer::begin()
+{
+    const auto next = (m_frame + 1) % m_queries.size();
+    const auto query = m_queries[next].get();
+
+    if (m_pending[next])
+    {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            // Skip measuring this frame rather than wait for the result.
+            return;
+        }
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+        m_time = static_cast<double>(elapsed) / 1'000'000.0;
+        m_average_time = m_average_time == 0.0 ? m_time : 0.95 * m_average_time + 0.05 * m_time;
+    }
+
+    m_frame = next;
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    m_pending[next] = true;
+    m_active = true;
+}
+
+void GpuTimer::end()
+{
+    if (m_active)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_active = false;
+    }
+}
+
+double GpuTimer::get_time() const
+{
+    return m_time;
+}
+
+double GpuTimer::get_average_time() const
+{
+    return m_average_time;
+}
@@ -0,0 +1,36 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <array>
+
+#include <glad/glad.h>
+
+#include "GLObject.h"
+#include "RingBuffer.h"
+
+// Measures the GPU time of a range of commands with GL_TIME_ELAPSED queries. Results are read a
+// few frames later, once they are available, so measuring never stalls the pipeline.
+class GpuTimer
+{
+    std::array<QueryObject, RingBuffer::FRAMES_IN_FLIGHT> m_queries;
+    std::array<bool, RingBuffer::FRAMES_IN_FLIGHT> m_pending{};
+    std::size_t m_frame{};
+    bool m_active{false};
+    double m_time{};
+    double m_average_time{};
+
+  public:
+    explicit GpuTimer();
+    GpuTimer(const GpuTimer &) = delete;
+    const GpuTimer &operator=(const GpuTimer &) = delete;
+
+    void begin();
+    void end();
+
+    // The last available result in milliseconds.
+    [[nodiscard]] double get_time() const;
+    // An exponential moving average of the results in milliseconds.
+    [[nodiscard]] double get_average_time() const;
+};
+
+#endif // GPU_TIMER_H
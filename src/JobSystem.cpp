@@ -0,0 +1,218 @@
+#include "JobSystem.h"
+
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace
+{
+// Attempts to find a job before a worker goes to sleep, so that the jobs of a frame, which arrive
+// in quick succession, do not pay for waking it up every time.
+constexpr int SPIN_COUNT = 64;
+
+thread_local constinit std::size_t thread_index = JobSystem::NO_THREAD;
+} // namespace
+
+bool JobSystem::Counter::is_done() const
+{
+    return m_pending.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem(const std::size_t thread_count) : m_thread_limit(thread_count)
+{
+    if (thread_count == 0)
+    {
+        throw std::runtime_error("job system needs at least one thread");
+    }
+    if (thread_index != NO_THREAD)
+    {
+        throw std::runtime_error(
+            fmt::format("thread {} already belongs to a job system", thread_index)
+        );
+    }
+
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        m_threads.push_back(std::make_unique<Thread>());
+    }
+    thread_index = 0;
+    for (std::size_t i = 1; i < thread_count; ++i)
+    {
+        m_workers.emplace_back([this, i] {
+            thread_index = i;
+            work(i);
+        });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    m_stopping.store(true, std::memory_order_relaxed);
+    wake();
+    m_workers.clear();
+    thread_index = NO_THREAD;
+}
+
+void JobSystem::run(
+    Counter &counter, const Function function, void *data, const std::uint32_t begin,
+    const std::uint32_t end
+)
+{
+    push(counter, function, data, begin, end);
+    wake();
+}
+
+void JobSystem::wait(Counter &counter)
+{
+    const auto thread = get_thread_index();
+    while (!counter.is_done())
+    {
+        if (!run_one(thread))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::set_thread_limit(const std::size_t limit)
+{
+    m_thread_limit.store(std::clamp<std::size_t>(limit, 1, m_threads.size()));
+    wake();
+}
+
+std::size_t JobSystem::get_thread_limit() const
+{
+    return m_thread_limit.load(std::memory_order_relaxed);
+}
+
+std::size_t JobSystem::get_thread_count() const
+{
+    return m_threads.size();
+}
+
+std::size_t JobSystem::get_thread_index()
+{
+    return thread_index;
+}
+
+void JobSystem::push(
+    Counter &counter, const Function function, void *data, const std::uint32_t begin,
+    const std::uint32_t end
+)
+{
+    const auto index = get_thread_index();
+    if (index >= m_threads.size())
+    {
+        throw std::runtime_error("jobs can only be submitted from the threads of the job system");
+    }
+
+    const Job job{
+        .function = function,
+        .data = data,
+        .begin = begin,
+        .end = end,
+        .counter = &counter,
+    };
+    counter.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+    // A slot is only reused once its job has been taken and copied out, also by a thief that
+    // has stolen it but not run it yet.
+    auto &thread = *m_threads[index];
+    for (std::size_t i = 0; i < QUEUE_SIZE; ++i)
+    {
+        auto &slot = thread.slots[(thread.next_slot + i) % QUEUE_SIZE];
+        if (slot.busy.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        slot.job = job;
+        slot.busy.store(true, std::memory_order_relaxed);
+        if (thread.queue.push(&slot))
+        {
+            thread.next_slot = (thread.next_slot + i + 1) % QUEUE_SIZE;
+            return;
+        }
+        slot.busy.store(false, std::memory_order_relaxed);
+        break;
+    }
+
+    // Every slot or the deque is full, so the job runs right away instead.
+    execute(job);
+}
+
+void JobSystem::wake()
+{
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_all();
+}
+
+bool JobSystem::run_one(const std::size_t thread)
+{
+    Slot *slot;
+    if (m_threads[thread]->queue.pop(slot))
+    {
+        execute(*slot);
+        return true;
+    }
+
+    // Threads above the limit are stolen from as well, they may have had jobs queued when the
+    // limit was lowered.
+    const auto thread_count = m_threads.size();
+    for (std::size_t i = 1; i < thread_count; ++i)
+    {
+        if (m_threads[(thread + i) % thread_count]->queue.steal(slot))
+        {
+            execute(*slot);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(Slot &slot)
+{
+    const auto job = slot.job;
+    slot.busy.store(false, std::memory_order_release);
+    execute(job);
+}
+
+void JobSystem::execute(const Job &job)
+{
+    job.function(job.data, job.begin, job.end);
+    job.counter->m_pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::work(const std::size_t thread)
+{
+    while (!m_stopping.load(std::memory_order_relaxed))
+    {
+        if (thread >= get_thread_limit())
+        {
+            const auto signal = m_signal.load(std::memory_order_acquire);
+            if (thread >= get_thread_limit() && !m_stopping.load(std::memory_order_relaxed))
+            {
+                m_signal.wait(signal, std::memory_order_acquire);
+            }
+            continue;
+        }
+
+        auto found = false;
+        for (auto i = 0; i < SPIN_COUNT && !found; ++i)
+        {
+            found = run_one(thread);
+        }
+        if (found)
+        {
+            continue;
+        }
+
+        // Checked once more after reading the signal, so that work submitted in between is not
+        // slept through.
+        const auto signal = m_signal.load(std::memory_order_acquire);
+        if (!run_one(thread) && !m_stopping.load(std::memory_order_relaxed))
+        {
+            m_signal.wait(signal, std::memory_order_acquire);
+        }
+    }
+}
@@ -0,0 +1,157 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "WorkStealingDeque.h"
+
+// Runs jobs on a pool of worker threads. Every thread, including the one that created the system,
+// pushes the jobs it submits onto its own deque and steals from the others when that runs dry.
+// Jobs are plain function pointers with a range, so submitting one never allocates.
+//
+// Dependencies are expressed with counters: every job submitted with a counter increments it and
+// decrements it when done, and `wait` runs other jobs until the counter reaches zero. Jobs that
+// depend on others are submitted after waiting on their counter.
+//
+// Thread 0 is the thread that created the system, the workers are 1 and up, which matches the
+// thread indices of FrameArenas.
+class JobSystem
+{
+  public:
+    // Jobs that a thread can have submitted and not yet finished at a time. Jobs submitted beyond
+    // that run right away on the submitting thread.
+    static constexpr std::size_t QUEUE_SIZE = 1024;
+    static constexpr std::size_t NO_THREAD = ~std::size_t{0};
+
+    using Function = void (*)(void *data, std::uint32_t begin, std::uint32_t end);
+
+    class Counter
+    {
+        std::atomic<std::uint32_t> m_pending{0};
+
+        friend class JobSystem;
+
+      public:
+        explicit Counter() = default;
+        Counter(const Counter &) = delete;
+        const Counter &operator=(const Counter &) = delete;
+
+        [[nodiscard]] bool is_done() const;
+    };
+
+  private:
+    struct Job
+    {
+        Function function;
+        void *data;
+        std::uint32_t begin;
+        std::uint32_t end;
+        Counter *counter;
+    };
+
+    struct Slot
+    {
+        Job job;
+        // Set by the owning thread when it submits the job, cleared by whichever thread runs it
+        // once the job has been copied out.
+        std::atomic<bool> busy{false};
+    };
+
+    struct Thread
+    {
+        WorkStealingDeque<Slot *, QUEUE_SIZE> queue;
+        std::array<Slot, QUEUE_SIZE> slots{};
+        // Where the search for a free slot starts.
+        std::size_t next_slot{};
+    };
+
+    std::vector<std::unique_ptr<Thread>> m_threads;
+    std::vector<std::jthread> m_workers;
+    // Threads at or above the limit do not run jobs.
+    std::atomic<std::size_t> m_thread_limit;
+    // Incremented whenever there is new work or the limit changed, to wake sleeping workers.
+    std::atomic<std::uint32_t> m_signal{0};
+    std::atomic<bool> m_stopping{false};
+
+  public:
+    // `thread_count` includes the calling thread, so 1 creates no workers.
+    explicit JobSystem(std::size_t thread_count);
+    JobSystem(const JobSystem &) = delete;
+    const JobSystem &operator=(const JobSystem &) = delete;
+    ~JobSystem();
+
+    // Submits `function(data, begin, end)`. Must be called from one of the system's threads.
+    void run(
+        Counter &counter, Function function, void *data, std::uint32_t begin = 0,
+        std::uint32_t end = 1
+    );
+    // Submits `function()`, which has to stay alive until the counter is done.
+    template <typename F> void run(Counter &counter, F &function)
+    {
+        const auto call = [](void *data, std::uint32_t, std::uint32_t) {
+            (*static_cast<F *>(data))();
+        };
+        run(counter, call, std::addressof(function));
+    }
+    // Runs jobs until the counter reaches zero.
+    void wait(Counter &counter);
+
+    // Calls `function(begin, end)` for chunks of at least `grain` of the range [0, count) in
+    // parallel, and returns once all of them are done.
+    template <typename F>
+    void parallel_for(const std::uint32_t count, const std::uint32_t grain, F &&function)
+    {
+        const auto chunk = std::max<std::uint32_t>(
+            {grain, 1, static_cast<std::uint32_t>((count + QUEUE_SIZE - 1) / QUEUE_SIZE)}
+        );
+        if (count <= chunk || get_thread_limit() == 1)
+        {
+            if (count > 0)
+            {
+                function(0, count);
+            }
+            return;
+        }
+
+        const auto call = [](void *data, const std::uint32_t begin, const std::uint32_t end) {
+            (*static_cast<std::remove_reference_t<F> *>(data))(begin, end);
+        };
+        Counter counter;
+        for (std::uint32_t begin = 0; begin < count; begin += chunk)
+        {
+            push(counter, call, std::addressof(function), begin, std::min(begin + chunk, count));
+        }
+        wake();
+        wait(counter);
+    }
+
+    // Limits the threads that run jobs to the first `limit` ones, e.g. to measure the scaling.
+    void set_thread_limit(std::size_t limit);
+    [[nodiscard]] std::size_t get_thread_limit() const;
+    [[nodiscard]] std::size_t get_thread_count() const;
+    // The index of the calling thread, or NO_THREAD if it does not belong to a job system.
+    [[nodiscard]] static std::size_t get_thread_index();
+
+  private:
+    void push(
+        Counter &counter, Function function, void *data, std::uint32_t begin, std::uint32_t end
+    );
+    void wake();
+    // Runs a job from the thread's own deque or one stolen from another. Returns whether there
+    // was one.
+    bool run_one(std::size_t thread);
+    // Frees the slot before running its job.
+    static void execute(Slot &slot);
+    static void execute(const Job &job);
+    void work(std::size_t thread);
+};
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,59 @@
+#include "LinearArena.h"
+
+#include <algorithm>
+
+LinearArena::LinearArena(const std::size_t capacity, std::pmr::memory_resource *upstream)
+    : m_data(std::make_unique_for_overwrite<std::byte[]>(capacity)),
+      m_capacity(capacity),
+      m_overflow(upstream)
+{
+}
+
+void LinearArena::reset()
+{
+    m_head = 0;
+    m_overflow_bytes = 0;
+    m_overflow.release();
+    m_stats.used = 0;
+}
+
+const LinearArena::Stats &LinearArena::get_stats() const
+{
+    return m_stats;
+}
+
+std::size_t LinearArena::get_capacity() const
+{
+    return m_capacity;
+}
+
+void *LinearArena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+    const auto address = reinterpret_cast<std::uintptr_t>(m_data.get());
+    const auto offset = ((address + m_head + alignment - 1) & ~(alignment - 1)) - address;
+    void *pointer;
+    if (offset + bytes <= m_capacity)
+    {
+        pointer = m_data.get() + offset;
+        m_head = offset + bytes;
+    }
+    else
+    {
+        pointer = m_overflow.allocate(bytes, alignment);
+        m_overflow_bytes += bytes;
+        ++m_stats.overflows;
+    }
+
+    m_stats.used = m_head + m_overflow_bytes;
+    m_stats.high_water_mark = std::max(m_stats.high_water_mark, m_stats.used);
+    return pointer;
+}
+
+void LinearArena::do_deallocate(void *, std::size_t, std::size_t)
+{
+}
+
+bool LinearArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,53 @@
+#ifndef LINEAR_ARENA_H
+#define LINEAR_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+// A memory resource that hands out memory by bumping a pointer through one fixed block and frees
+// it all at once in `reset`. Deallocating single allocations does nothing. When the block is
+// exhausted, allocations spill over to the upstream resource until the next reset and are counted,
+// so that the block size can be raised. Not thread-safe, every thread needs its own arena.
+class LinearArena : public std::pmr::memory_resource
+{
+  public:
+    struct Stats
+    {
+        std::size_t used{};
+        // The most bytes allocated between two resets, including those that spilled over.
+        std::size_t high_water_mark{};
+        std::uint64_t overflows{};
+    };
+
+  private:
+    std::unique_ptr<std::byte[]> m_data;
+    std::size_t m_capacity;
+    std::size_t m_head{};
+    std::size_t m_overflow_bytes{};
+    std::pmr::monotonic_buffer_resource m_overflow;
+
+    Stats m_stats;
+
+  public:
+    explicit LinearArena(
+        std::size_t capacity,
+        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()
+    );
+    LinearArena(const LinearArena &) = delete;
+    const LinearArena &operator=(const LinearArena &) = delete;
+
+    // Frees everything allocated since the last reset.
+    void reset();
+
+    [[nodiscard]] const Stats &get_stats() const;
+    [[nodiscard]] std::size_t get_capacity() const;
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+};
+
+#endif // LINEAR_ARENA_H
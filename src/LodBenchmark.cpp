@@ -0,0 +1,61 @@
+#include "LodBenchmark.h"
+
+#include <spdlog/spdlog.h>
+
+void LodBenchmark::start()
+{
+    m_run = 0;
+    m_frame = 0;
+    m_sums = {};
+}
+
+bool LodBenchmark::is_running() const
+{
+    return m_run >= 0;
+}
+
+bool LodBenchmark::uses_lods() const
+{
+    return m_run == 1;
+}
+
+void LodBenchmark::record(const std::uint64_t triangles, const double milliseconds)
+{
+    if (!is_running())
+    {
+        return;
+    }
+
+    if (m_frame++ >= WARMUP_FRAMES)
+    {
+        m_sums[m_run].triangles += static_cast<double>(triangles);
+        m_sums[m_run].milliseconds += milliseconds;
+    }
+    if (m_frame < WARMUP_FRAMES + MEASURED_FRAMES)
+    {
+        return;
+    }
+
+    m_sums[m_run].triangles /= MEASURED_FRAMES;
+    m_sums[m_run].milliseconds /= MEASURED_FRAMES;
+    const auto &[average_triangles, average_milliseconds] = m_sums[m_run];
+    spdlog::info(
+        "LOD benchmark, {}: {:.3f} M triangles in {:.3f} ms per frame, {:.2f} G triangles/s",
+        uses_lods() ? "levels of detail" : "full detail",
+        average_triangles / 1e6,
+        average_milliseconds,
+        average_milliseconds > 0.0 ? average_triangles / average_milliseconds / 1e6 : 0.0
+    );
+
+    m_frame = 0;
+    if (++m_run == static_cast<int>(m_sums.size()))
+    {
+        m_run = -1;
+        m_results = m_sums;
+    }
+}
+
+const std::optional<std::array<LodBenchmark::Result, 2>> &LodBenchmark::get_results() const
+{
+    return m_results;
+}
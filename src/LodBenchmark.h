@@ -0,0 +1,50 @@
+#ifndef LOD_BENCHMARK_H
+#define LOD_BENCHMARK_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "RingBuffer.h"
+
+// Measures the triangle throughput of the shadow and geometry passes at the current view, first
+// at full detail and then with levels of detail, over a fixed number of frames each.
+class LodBenchmark
+{
+  public:
+    // GPU queries are read a few frames late, so the first frames of a run still show the
+    // previous one.
+    static constexpr int WARMUP_FRAMES = 2 * RingBuffer::FRAMES_IN_FLIGHT;
+    static constexpr int MEASURED_FRAMES = 120;
+
+    struct Result
+    {
+        // Averages per frame.
+        double triangles{};
+        double milliseconds{};
+    };
+
+  private:
+    // -1 while not running, otherwise 0 at full detail and 1 with levels of detail.
+    int m_run{-1};
+    int m_frame{};
+    std::array<Result, 2> m_sums{};
+    std::optional<std::array<Result, 2>> m_results;
+
+  public:
+    explicit LodBenchmark() = default;
+    LodBenchmark(const LodBenchmark &) = delete;
+    const LodBenchmark &operator=(const LodBenchmark &) = delete;
+
+    void start();
+    [[nodiscard]] bool is_running() const;
+    // Whether the current run uses levels of detail.
+    [[nodiscard]] bool uses_lods() const;
+    // Records the measurements of a frame and advances to the next run when enough were taken.
+    void record(std::uint64_t triangles, double milliseconds);
+
+    // The results at full detail and with levels of detail, once a benchmark has finished.
+    [[nodiscard]] const std::optional<std::array<Result, 2>> &get_results() const;
+};
+
+#endif // LOD_BENCHMARK_H
@@ -0,0 +1,26 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <glad/glad.h>
+
+#include "ResourcePool.h"
+#include "Texture.h"
+
+using TextureHandle = Handle<Texture>;
+
+struct Material
+{
+    TextureHandle m_diffuse;
+    TextureHandle m_normal;
+};
+
+using MaterialHandle = Handle<Material>;
+
+// The texture names of a material, resolved once so that draw loops bind them by index.
+struct MaterialTextures
+{
+    GLuint diffuse;
+    GLuint normal;
+};
+
+#endif // MATERIAL_H
@@ -1,7 +1,9 @@
 #include "Mesh.h"
 
 #include <array>
-#include <utility>
+#include <cstddef>
+
+#include "GLState.h"
 
 constexpr std::array PLANE_VERTICES = {
     Mesh::Vertex{{-1.0, -1.0, 0.0}, {0.0, 0.0, 1.0}, {0.0, 0.0}},
@@ -66,90 +68,34 @@ Mesh Mesh::skybox()
     return Mesh(SKYBOX_VERTICES);
 }
 
-Mesh::Mesh(
-    const std::span<const Vertex> vertices, const std::span<const std::uint32_t> indices,
-    std::shared_ptr<Material> material
-)
+Mesh::Mesh(const std::span<const Vertex> vertices, const std::span<const std::uint32_t> indices)
     : m_vertex_count(static_cast<GLsizei>(vertices.size())),
-      m_index_count(static_cast<GLsizei>(indices.size())), m_material(std::move(material))
+      m_index_count(static_cast<GLsizei>(indices.size())),
+      m_vbo(static_cast<GLsizeiptr>(vertices.size_bytes()), vertices.data(), 0),
+      m_vao(VertexArrayObject::create())
 {
-    glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
-
-    glBindVertexArray(m_vao);
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)),
-        vertices.data(),
-        GL_STATIC_DRAW
-    );
+    glVertexArrayVertexBuffer(m_vao.get(), 0, m_vbo.get_handle(), 0, sizeof(Vertex));
 
     if (m_index_count != 0)
     {
-        glGenBuffers(1, &m_ebo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-        glBufferData(
-            GL_ELEMENT_ARRAY_BUFFER,
-            static_cast<GLsizeiptr>(indices.size() * sizeof(std::uint32_t)),
-            indices.data(),
-            GL_STATIC_DRAW
-        );
+        m_ebo.emplace(static_cast<GLsizeiptr>(indices.size_bytes()), indices.data(), 0);
+        glVertexArrayElementBuffer(m_vao.get(), m_ebo->get_handle());
     }
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(
-        0,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Vertex),
-        reinterpret_cast<void *>(offsetof(Vertex, position))
-    );
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(
-        1,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Vertex),
-        reinterpret_cast<void *>(offsetof(Vertex, normal))
-    );
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(
-        2,
-        2,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Vertex),
-        reinterpret_cast<void *>(offsetof(Vertex, tex_coords))
-        );
-
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(
-        3,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Vertex),
-        reinterpret_cast<void *>(offsetof(Vertex, tangent))
-    );
-
-    glBindVertexArray(0);
+    const auto attribute = [this](GLuint index, GLint size, GLuint offset) {
+        glEnableVertexArrayAttrib(m_vao.get(), index);
+        glVertexArrayAttribFormat(m_vao.get(), index, size, GL_FLOAT, GL_FALSE, offset);
+        glVertexArrayAttribBinding(m_vao.get(), index, 0);
+    };
+    attribute(0, 3, offsetof(Vertex, position));
+    attribute(1, 3, offsetof(Vertex, normal));
+    attribute(2, 2, offsetof(Vertex, tex_coords));
+    attribute(3, 3, offsetof(Vertex, tangent));
 }
 
 void Mesh::draw() const
 {
-    if (m_material)
-    {
-        m_material->m_diffuse->bind(GL_TEXTURE0);
-        m_material->m_normal->bind(GL_TEXTURE1);
-    }
-
-    glBindVertexArray(m_vao);
+    GLState::get().bind_vertex_array(m_vao.get());
     if (m_index_count != 0)
     {
         glDrawElements(GL_TRIANGLES, m_index_count, GL_UNSIGNED_INT, nullptr);
@@ -1,26 +1,16 @@
 #ifndef MESH_H
 #define MESH_H
 
-#include <memory>
+#include <cstdint>
+#include <optional>
 #include <span>
 
 #include <glad/glad.h>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
-#include <utility>
 
-#include "Texture.h"
-
-struct Material
-{
-    std::shared_ptr<Texture> m_diffuse;
-    std::shared_ptr<Texture> m_normal;
-
-    explicit Material(std::shared_ptr<Texture> diffuse, std::shared_ptr<Texture> normal)
-        : m_diffuse(std::move(diffuse)), m_normal(std::move(normal))
-    {
-    }
-};
+#include "Buffer.h"
+#include "GLObject.h"
 
 class Mesh
 {
@@ -36,19 +26,19 @@ class Mesh
   private:
     GLsizei m_vertex_count{};
     GLsizei m_index_count{};
-    GLuint m_vao{};
-    GLuint m_vbo{};
-    GLuint m_ebo{};
-    std::shared_ptr<Material> m_material{};
+    Buffer m_vbo;
+    std::optional<Buffer> m_ebo;
+    VertexArrayObject m_vao;
 
   public:
     [[nodiscard]] static Mesh plane();
     [[nodiscard]] static Mesh skybox();
 
-    explicit Mesh(
-        std::span<const Vertex> vertices, std::span<const std::uint32_t> indices = {},
-        std::shared_ptr<Material> material = {}
-    );
+    explicit Mesh(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices = {});
+    Mesh(const Mesh &) = delete;
+    const Mesh &operator=(const Mesh &) = delete;
+    Mesh(Mesh &&) = default;
+    Mesh &operator=(Mesh &&) = default;
 
     void draw() const;
 };
@@ -0,0 +1,711 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+
+#include <spdlog/spdlog.h>
+
+#include "MeshSimplifier.h"
+
+namespace
+{
+// A FIFO post-transform cache. A vertex is cached if it was inserted less than `size` misses ago.
+class FifoCache
+{
+    std::vector<std::uint32_t> m_timestamps;
+    std::uint32_t m_size;
+    std::uint32_t m_time;
+
+  public:
+    explicit FifoCache(const std::size_t vertex_count, const std::size_t size)
+        : m_timestamps(vertex_count, 0), m_size(static_cast<std::uint32_t>(size)),
+          m_time(m_size + 1)
+    {
+    }
+
+    // Returns whether the vertex was missing from the cache.
+    bool access(const std::uint32_t vertex)
+    {
+        if (m_time - m_timestamps[vertex] > m_size)
+        {
+            m_timestamps[vertex] = m_time++;
+            return true;
+        }
+        return false;
+    }
+
+    unsigned access_triangle(const std::span<const std::uint32_t> indices, const std::size_t t)
+    {
+        return access(indices[3 * t]) + access(indices[3 * t + 1]) + access(indices[3 * t + 2]);
+    }
+
+    void flush()
+    {
+        m_time += m_size + 1;
+    }
+};
+
+std::size_t cluster_end(
+    const std::span<const std::size_t> clusters, const std::size_t cluster,
+    const std::size_t triangle_count
+)
+{
+    return cluster + 1 < clusters.size() ? clusters[cluster + 1] : triangle_count;
+}
+
+// Hashes the indices and texture coordinates, which a translation leaves unchanged bit for bit.
+std::size_t hash_topology(const MeshGeometry &mesh)
+{
+    auto hash = mesh.vertices.size();
+    const auto combine = [&hash](const std::size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+    for (const auto index : mesh.indices)
+    {
+        combine(index);
+    }
+    for (const auto &vertex : mesh.vertices)
+    {
+        combine(std::bit_cast<std::uint32_t>(vertex.tex_coords.x));
+        combine(std::bit_cast<std::uint32_t>(vertex.tex_coords.y));
+    }
+    return hash;
+}
+
+bool is_translated_copy(
+    const MeshGeometry &original, const MeshGeometry &copy, const glm::vec3 &offset,
+    const float position_tolerance
+)
+{
+    if (original.vertices.size() != copy.vertices.size() ||
+        !std::ranges::equal(original.indices, copy.indices))
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < original.vertices.size(); ++i)
+    {
+        const auto &a = original.vertices[i];
+        const auto &b = copy.vertices[i];
+        const auto direction_error = std::max(
+            glm::distance(a.normal, b.normal),
+            glm::distance(a.tangent, b.tangent)
+        );
+        if (glm::distance(a.position + offset, b.position) > position_tolerance ||
+            direction_error > MeshOptimizer::INSTANCE_DIRECTION_TOLERANCE ||
+            a.tex_coords != b.tex_coords)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+VertexCacheStats MeshOptimizer::analyze_vertex_cache(
+    const std::span<const std::uint32_t> indices, const std::size_t vertex_count
+)
+{
+    const auto triangle_count = indices.size() / 3;
+    if (triangle_count == 0)
+    {
+        return {};
+    }
+
+    FifoCache cache(vertex_count, CACHE_SIZE);
+    std::size_t misses = 0;
+    for (std::size_t t = 0; t < triangle_count; ++t)
+    {
+        misses += cache.access_triangle(indices, t);
+    }
+
+    std::vector<bool> used(vertex_count, false);
+    for (const auto index : indices)
+    {
+        used[index] = true;
+    }
+    const auto used_count = std::ranges::count(used, true);
+
+    return VertexCacheStats{
+        .acmr = static_cast<double>(misses) / static_cast<double>(triangle_count),
+        .atvr = static_cast<double>(misses) / static_cast<double>(used_count),
+    };
+}
+
+MeshOptimizationReport MeshOptimizer::optimize(MeshGeometry &mesh)
+{
+    MeshOptimizationReport report;
+    report.before = analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+
+    auto clusters = optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+    clusters = split_clusters(mesh.indices, mesh.vertices.size(), clusters);
+    optimize_overdraw(mesh.indices, mesh.vertices, clusters);
+    optimize_vertex_fetch(mesh);
+    report.after = analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+
+    build_lods(mesh);
+    mesh.meshlets.clear();
+    for (std::uint32_t lod = 0; lod < mesh.lods.size(); ++lod)
+    {
+        const auto &[first_index, index_count, error] = mesh.lods[lod];
+        const auto indices = std::span(mesh.indices).subspan(first_index, index_count);
+        for (auto meshlet : build_meshlets(mesh.vertices, indices))
+        {
+            meshlet.first_index += first_index;
+            meshlet.lod = lod;
+            mesh.meshlets.push_back(meshlet);
+        }
+    }
+    return report;
+}
+
+void MeshOptimizer::optimize_all(const std::span<MeshGeometry> meshes, JobSystem &jobs)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<MeshOptimizationReport> reports(meshes.size());
+    // One mesh per job, the meshes differ too much in size for larger chunks to balance well.
+    jobs.parallel_for(
+        static_cast<std::uint32_t>(meshes.size()),
+        1,
+        [&](const std::uint32_t begin, const std::uint32_t end) {
+            for (auto mesh = begin; mesh < end; ++mesh)
+            {
+                reports[mesh] = optimize(meshes[mesh]);
+            }
+        }
+    );
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    auto total_acmr_before = 0.0;
+    auto total_acmr_after = 0.0;
+    std::size_t total_triangles = 0;
+    std::size_t total_meshlets = 0;
+    std::size_t cone_meshlets = 0;
+    for (std::size_t i = 0; i < meshes.size(); ++i)
+    {
+        const auto &[before, after] = reports[i];
+        const auto &lods = meshes[i].lods;
+        const auto triangles = lods.front().index_count / 3;
+        std::string lod_triangles;
+        for (std::size_t lod = 1; lod < lods.size(); ++lod)
+        {
+            lod_triangles += fmt::format(" -> {}", lods[lod].index_count / 3);
+        }
+        spdlog::info(
+            "mesh {}: {}{} triangles in {} meshlets, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+            i,
+            triangles,
+            lod_triangles,
+            meshes[i].meshlets.size(),
+            before.acmr,
+            after.acmr,
+            before.atvr,
+            after.atvr
+        );
+        total_acmr_before += before.acmr * static_cast<double>(triangles);
+        total_acmr_after += after.acmr * static_cast<double>(triangles);
+        total_triangles += triangles;
+        for (const auto &meshlet : meshes[i].meshlets)
+        {
+            if (meshlet.lod == 0)
+            {
+                ++total_meshlets;
+                cone_meshlets += meshlet.cone.w < 1.0f;
+            }
+        }
+    }
+    if (total_triangles != 0)
+    {
+        spdlog::info(
+            "optimized {} meshes in {:.1f} ms, overall ACMR {:.3f} -> {:.3f}",
+            meshes.size(),
+            std::chrono::duration<double, std::milli>(elapsed).count(),
+            total_acmr_before / static_cast<double>(total_triangles),
+            total_acmr_after / static_cast<double>(total_triangles)
+        );
+        spdlog::info(
+            "{} meshlets at full detail, {:.1f} triangles on average, {:.0f}% can be cone culled",
+            total_meshlets,
+            static_cast<double>(total_triangles) / static_cast<double>(total_meshlets),
+            100.0 * static_cast<double>(cone_meshlets) / static_cast<double>(total_meshlets)
+        );
+    }
+}
+
+std::vector<MeshInstance> MeshOptimizer::find_instances(const std::span<const MeshGeometry> meshes)
+{
+    std::vector<MeshInstance> instances(meshes.size());
+    std::unordered_map<std::size_t, std::vector<std::size_t>> originals;
+    std::vector<glm::vec3> minima(meshes.size());
+    std::size_t copies = 0;
+
+    for (std::size_t i = 0; i < meshes.size(); ++i)
+    {
+        instances[i].mesh = i;
+        const auto &vertices = meshes[i].vertices;
+        if (vertices.empty())
+        {
+            continue;
+        }
+
+        auto min = vertices.front().position;
+        auto max = vertices.front().position;
+        for (const auto &vertex : vertices)
+        {
+            min = glm::min(min, vertex.position);
+            max = glm::max(max, vertex.position);
+        }
+        minima[i] = min;
+        const auto tolerance = INSTANCE_POSITION_TOLERANCE * glm::distance(min, max);
+
+        auto &candidates = originals[hash_topology(meshes[i])];
+        const auto original = std::ranges::find_if(candidates, [&](const std::size_t j) {
+            return is_translated_copy(meshes[j], meshes[i], minima[i] - minima[j], tolerance);
+        });
+        if (original == candidates.end())
+        {
+            candidates.push_back(i);
+            continue;
+        }
+        instances[i] = MeshInstance{.mesh = *original, .offset = minima[i] - minima[*original]};
+        ++copies;
+    }
+
+    spdlog::info(
+        "{} of {} meshes are translated copies of another, {} unique meshes",
+        copies,
+        meshes.size(),
+        meshes.size() - copies
+    );
+    return instances;
+}
+
+void MeshOptimizer::build_lods(MeshGeometry &mesh)
+{
+    mesh.lods = {MeshLod{.index_count = static_cast<std::uint32_t>(mesh.indices.size())}};
+    if (mesh.indices.empty())
+    {
+        return;
+    }
+
+    auto min = glm::vec3(std::numeric_limits<float>::max());
+    auto max = glm::vec3(std::numeric_limits<float>::lowest());
+    for (const auto &vertex : mesh.vertices)
+    {
+        min = glm::min(min, vertex.position);
+        max = glm::max(max, vertex.position);
+    }
+    const auto max_error = LOD_MAX_ERROR * 0.5 * glm::distance(min, max);
+
+    MeshSimplifier simplifier(mesh.vertices, mesh.indices);
+    while (mesh.lods.size() < MAX_LODS)
+    {
+        const auto previous = mesh.lods.back().index_count;
+        simplifier.simplify(previous / 6 * 3, max_error);
+        const auto simplified = simplifier.get_indices();
+        if (simplified.empty() ||
+            static_cast<double>(simplified.size()) > LOD_MIN_REDUCTION * previous)
+        {
+            break;
+        }
+
+        mesh.lods.push_back(MeshLod{
+            .first_index = static_cast<std::uint32_t>(mesh.indices.size()),
+            .index_count = static_cast<std::uint32_t>(simplified.size()),
+            .error = static_cast<float>(simplifier.get_error()),
+        });
+        mesh.indices.insert(mesh.indices.end(), simplified.begin(), simplified.end());
+        optimize_vertex_cache(
+            std::span(mesh.indices).subspan(mesh.lods.back().first_index),
+            mesh.vertices.size()
+        );
+    }
+}
+
+std::vector<Meshlet> MeshOptimizer::build_meshlets(
+    const std::span<const Mesh::Vertex> vertices, const std::span<const std::uint32_t> indices
+)
+{
+    std::vector<Meshlet> meshlets;
+    // The meshlet that last referenced every vertex, offset by one so that 0 means none.
+    std::vector<std::uint32_t> owner(vertices.size(), 0);
+
+    Meshlet meshlet;
+    const auto finish = [&] {
+        if (meshlet.index_count != 0)
+        {
+            compute_meshlet_bounds(meshlet, vertices, indices);
+            meshlets.push_back(meshlet);
+        }
+        meshlet = Meshlet{.first_index = meshlet.first_index + meshlet.index_count};
+    };
+
+    for (std::size_t t = 0; t < indices.size() / 3; ++t)
+    {
+        const auto id = static_cast<std::uint32_t>(meshlets.size() + 1);
+        const auto a = indices[3 * t];
+        const auto b = indices[3 * t + 1];
+        const auto c = indices[3 * t + 2];
+        auto new_vertices = static_cast<std::uint32_t>(
+            (owner[a] != id) + (owner[b] != id && b != a) + (owner[c] != id && c != a && c != b)
+        );
+
+        if (meshlet.vertex_count + new_vertices > MESHLET_VERTICES ||
+            meshlet.index_count / 3 == MESHLET_TRIANGLES)
+        {
+            finish();
+            new_vertices = 3 - (b == a) - (c == a || c == b);
+        }
+
+        owner[a] = owner[b] = owner[c] = static_cast<std::uint32_t>(meshlets.size() + 1);
+        meshlet.vertex_count += new_vertices;
+        meshlet.index_count += 3;
+    }
+    finish();
+    return meshlets;
+}
+
+// The normal cone follows Kapoulkine's meshoptimizer: the cone of the triangle normals is widened
+// by 90 degrees and inverted, which gives the cone of view directions from which every triangle
+// is back facing.
+void MeshOptimizer::compute_meshlet_bounds(
+    Meshlet &meshlet, const std::span<const Mesh::Vertex> vertices,
+    const std::span<const std::uint32_t> indices
+)
+{
+    const auto triangles = indices.subspan(meshlet.first_index, meshlet.index_count);
+
+    auto min = glm::vec3(std::numeric_limits<float>::max());
+    auto max = glm::vec3(std::numeric_limits<float>::lowest());
+    for (const auto index : triangles)
+    {
+        min = glm::min(min, vertices[index].position);
+        max = glm::max(max, vertices[index].position);
+    }
+    const auto center = (min + max) * 0.5f;
+    auto radius = 0.0f;
+    for (const auto index : triangles)
+    {
+        radius = std::max(radius, glm::distance(center, vertices[index].position));
+    }
+    meshlet.bounds = glm::vec4(center, radius);
+
+    std::vector<glm::vec3> normals;
+    normals.reserve(triangles.size() / 3);
+    auto axis = glm::vec3(0.0f);
+    for (std::size_t t = 0; t < triangles.size(); t += 3)
+    {
+        const auto &a = vertices[triangles[t]].position;
+        const auto &b = vertices[triangles[t + 1]].position;
+        const auto &c = vertices[triangles[t + 2]].position;
+        const auto normal = glm::cross(b - a, c - a);
+        const auto length = glm::length(normal);
+        if (length > 0.0f)
+        {
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+    }
+
+    const auto axis_length = glm::length(axis);
+    if (normals.empty() || axis_length == 0.0f)
+    {
+        return;
+    }
+    axis = axis / axis_length;
+    auto min_dot = 1.0f;
+    for (const auto &normal : normals)
+    {
+        min_dot = std::min(min_dot, glm::dot(axis, normal));
+    }
+
+    // Cones wider than about 84 degrees would almost never cull anything.
+    if (min_dot > 0.1f)
+    {
+        meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - min_dot * min_dot));
+    }
+}
+
+// Tipsify, from Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced
+// Overdraw" (2007). Fans around one vertex at a time and picks the next vertex among those of the
+// fan that will still be in the cache, falling back to recently used ones at dead ends.
+std::vector<std::size_t> MeshOptimizer::optimize_vertex_cache(
+    const std::span<std::uint32_t> indices, const std::size_t vertex_count
+)
+{
+    const auto triangle_count = indices.size() / 3;
+    std::vector<std::size_t> clusters;
+    if (triangle_count == 0)
+    {
+        return clusters;
+    }
+
+    // The triangles adjacent to every vertex.
+    std::vector<std::uint32_t> live(vertex_count, 0);
+    for (const auto index : indices)
+    {
+        ++live[index];
+    }
+    std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+    std::inclusive_scan(live.begin(), live.end(), offsets.begin() + 1);
+    std::vector<std::uint32_t> adjacency(indices.size());
+    {
+        auto fill = offsets;
+        for (std::size_t t = 0; t < triangle_count; ++t)
+        {
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                adjacency[fill[indices[3 * t + k]]++] = static_cast<std::uint32_t>(t);
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> cache_time(vertex_count, 0);
+    std::uint32_t time = CACHE_SIZE + 1;
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<std::uint32_t> dead_end;
+    std::vector<std::uint32_t> candidates;
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    std::size_t cursor = 0;
+
+    const auto is_cached = [&](const std::uint32_t vertex) {
+        return time - cache_time[vertex] <= CACHE_SIZE;
+    };
+
+    constexpr auto NONE = std::numeric_limits<std::uint32_t>::max();
+    auto fanning = NONE;
+    while (true)
+    {
+        if (fanning == NONE)
+        {
+            // Dead end: continue with a recently used vertex, or any vertex with triangles left.
+            while (!dead_end.empty() && fanning == NONE)
+            {
+                if (live[dead_end.back()] > 0)
+                {
+                    fanning = dead_end.back();
+                }
+                dead_end.pop_back();
+            }
+            while (fanning == NONE && cursor < vertex_count)
+            {
+                if (live[cursor] > 0)
+                {
+                    fanning = static_cast<std::uint32_t>(cursor);
+                }
+                ++cursor;
+            }
+            if (fanning == NONE)
+            {
+                break;
+            }
+            if (!is_cached(fanning))
+            {
+                clusters.push_back(output.size() / 3);
+            }
+        }
+
+        candidates.clear();
+        for (auto i = offsets[fanning]; i < offsets[fanning + 1]; ++i)
+        {
+            const auto t = adjacency[i];
+            if (emitted[t])
+            {
+                continue;
+            }
+            emitted[t] = true;
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                const auto vertex = indices[3 * t + k];
+                output.push_back(vertex);
+                dead_end.push_back(vertex);
+                candidates.push_back(vertex);
+                --live[vertex];
+                if (!is_cached(vertex))
+                {
+                    cache_time[vertex] = time++;
+                }
+            }
+        }
+
+        // Prefer the vertex that entered the cache earliest among those whose remaining triangles
+        // can still be emitted before it is evicted.
+        fanning = NONE;
+        std::int64_t best_priority = -1;
+        for (const auto vertex : candidates)
+        {
+            if (live[vertex] == 0)
+            {
+                continue;
+            }
+            std::int64_t priority = 0;
+            const auto age = static_cast<std::int64_t>(time - cache_time[vertex]);
+            if (age + 2 * static_cast<std::int64_t>(live[vertex]) <=
+                static_cast<std::int64_t>(CACHE_SIZE))
+            {
+                priority = age;
+            }
+            if (priority > best_priority)
+            {
+                best_priority = priority;
+                fanning = vertex;
+            }
+        }
+    }
+
+    std::ranges::copy(output, indices.begin());
+    if (clusters.empty() || clusters.front() != 0)
+    {
+        clusters.insert(clusters.begin(), 0);
+    }
+    return clusters;
+}
+
+std::vector<std::size_t> MeshOptimizer::split_clusters(
+    const std::span<const std::uint32_t> indices, const std::size_t vertex_count,
+    const std::span<const std::size_t> clusters
+)
+{
+    const auto triangle_count = indices.size() / 3;
+    std::vector<std::size_t> result;
+    FifoCache cache(vertex_count, CACHE_SIZE);
+
+    for (std::size_t c = 0; c < clusters.size(); ++c)
+    {
+        const auto start = clusters[c];
+        const auto end = cluster_end(clusters, c, triangle_count);
+
+        cache.flush();
+        std::size_t misses = 0;
+        for (auto t = start; t < end; ++t)
+        {
+            misses += cache.access_triangle(indices, t);
+        }
+        const auto threshold =
+            OVERDRAW_THRESHOLD * static_cast<double>(misses) / static_cast<double>(end - start);
+
+        // Every split starts with a cold cache, so only split once the misses so far are
+        // amortized well enough.
+        cache.flush();
+        result.push_back(start);
+        misses = 0;
+        auto split_start = start;
+        for (auto t = start; t < end; ++t)
+        {
+            misses += cache.access_triangle(indices, t);
+            const auto triangles = t + 1 - split_start;
+            if (t + 1 < end &&
+                static_cast<double>(misses) / static_cast<double>(triangles) <= threshold)
+            {
+                cache.flush();
+                result.push_back(t + 1);
+                misses = 0;
+                split_start = t + 1;
+            }
+        }
+    }
+    return result;
+}
+
+// Draws the clusters facing away from the center of the mesh first, since they are the most
+// likely to occlude the others.
+void MeshOptimizer::optimize_overdraw(
+    const std::span<std::uint32_t> indices, const std::span<const Mesh::Vertex> vertices,
+    const std::span<const std::size_t> clusters
+)
+{
+    const auto triangle_count = indices.size() / 3;
+    if (clusters.size() < 2)
+    {
+        return;
+    }
+
+    struct Cluster
+    {
+        glm::vec3 centroid{0.0f};
+        // Sum of the area-weighted triangle normals.
+        glm::vec3 normal{0.0f};
+        float area{};
+    };
+    std::vector<Cluster> cluster_data(clusters.size());
+    auto mesh_centroid = glm::vec3(0.0f);
+    auto mesh_area = 0.0f;
+
+    for (std::size_t c = 0; c < clusters.size(); ++c)
+    {
+        auto &cluster = cluster_data[c];
+        for (auto t = clusters[c]; t < cluster_end(clusters, c, triangle_count); ++t)
+        {
+            const auto &a = vertices[indices[3 * t]].position;
+            const auto &b = vertices[indices[3 * t + 1]].position;
+            const auto &c_position = vertices[indices[3 * t + 2]].position;
+            const auto normal = glm::cross(b - a, c_position - a);
+            const auto area = glm::length(normal);
+            cluster.centroid += (a + b + c_position) * (area / 3.0f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+        mesh_centroid += cluster.centroid;
+        mesh_area += cluster.area;
+        if (cluster.area > 0.0f)
+        {
+            cluster.centroid = cluster.centroid / cluster.area;
+        }
+    }
+    if (mesh_area > 0.0f)
+    {
+        mesh_centroid = mesh_centroid / mesh_area;
+    }
+
+    std::vector<float> sort_keys(clusters.size());
+    for (std::size_t c = 0; c < clusters.size(); ++c)
+    {
+        const auto &cluster = cluster_data[c];
+        const auto length = glm::length(cluster.normal);
+        sort_keys[c] = length > 0.0f
+                           ? glm::dot(cluster.centroid - mesh_centroid, cluster.normal / length)
+                           : 0.0f;
+    }
+    std::vector<std::size_t> order(clusters.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, std::greater{}, [&](const std::size_t c) {
+        return sort_keys[c];
+    });
+
+    const std::vector<std::uint32_t> source(indices.begin(), indices.end());
+    auto output = indices.begin();
+    for (const auto c : order)
+    {
+        const auto first = static_cast<std::ptrdiff_t>(3 * clusters[c]);
+        const auto last = static_cast<std::ptrdiff_t>(3 * cluster_end(clusters, c, triangle_count));
+        output = std::copy(source.begin() + first, source.begin() + last, output);
+    }
+}
+
+void MeshOptimizer::optimize_vertex_fetch(MeshGeometry &mesh)
+{
+    constexpr auto UNUSED = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> remap(mesh.vertices.size(), UNUSED);
+    std::vector<Mesh::Vertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+
+    for (auto &index : mesh.indices)
+    {
+        if (remap[index] == UNUSED)
+        {
+            remap[index] = static_cast<std::uint32_t>(vertices.size());
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices = std::move(vertices);
+}
@@ -0,0 +1,140 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "JobSystem.h"
+#include "Mesh.h"
+
+// A contiguous run of triangles of a mesh that is culled as a unit.
+struct Meshlet
+{
+    std::uint32_t first_index{};
+    std::uint32_t index_count{};
+    std::uint32_t vertex_count{};
+    // xyz = bounding sphere center, w = radius.
+    glm::vec4 bounds{0.0f};
+    // xyz = average triangle normal, w = sine of the widest angle between it and a triangle
+    // normal. All triangles face away from any viewer for which the direction towards the
+    // meshlet is within acos(w) of the axis. A w of 1 means that cannot happen.
+    glm::vec4 cone{0.0f, 0.0f, 0.0f, 1.0f};
+    // The level of detail the meshlet belongs to.
+    std::uint32_t lod{};
+};
+
+// A simplified version of a mesh, as a range of its indices.
+struct MeshLod
+{
+    std::uint32_t first_index{};
+    std::uint32_t index_count{};
+    // How far the simplified surface may be from the original, in model units.
+    float error{};
+};
+
+// The indices of all levels of detail follow each other, finest first, and address the same
+// vertices.
+struct MeshGeometry
+{
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+    std::vector<MeshLod> lods;
+    std::vector<Meshlet> meshlets;
+};
+
+// Where the geometry of a mesh was found first in a list of meshes: the index of that mesh, the
+// mesh itself if it is the first, and how far this copy is moved from it.
+struct MeshInstance
+{
+    std::size_t mesh{};
+    glm::vec3 offset{0.0f};
+};
+
+// Efficiency of an index buffer with a simulated FIFO post-transform cache.
+struct VertexCacheStats
+{
+    // Average cache miss ratio, vertex shader invocations per triangle (0.5 at best).
+    double acmr{};
+    // Average transformed vertex ratio, vertex shader invocations per vertex (1 at best).
+    double atvr{};
+};
+
+struct MeshOptimizationReport
+{
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+class MeshOptimizer
+{
+  public:
+    static constexpr std::size_t CACHE_SIZE = 16;
+    // How much worse than after vertex cache optimization the ACMR may get in exchange for less
+    // overdraw.
+    static constexpr double OVERDRAW_THRESHOLD = 1.05;
+    static constexpr std::size_t MESHLET_VERTICES = 64;
+    static constexpr std::size_t MESHLET_TRIANGLES = 124;
+    static constexpr std::size_t MAX_LODS = 4;
+    // The largest error of a level of detail, relative to the bounding sphere radius of the mesh.
+    static constexpr double LOD_MAX_ERROR = 0.05;
+    // A level of detail is only kept if it has at most this fraction of the triangles of the
+    // previous one.
+    static constexpr double LOD_MIN_REDUCTION = 0.8;
+    // How far the vertices of two meshes may be apart for one to count as a translated copy of
+    // the other, relative to the diagonal of the bounding box, and how far their normals and
+    // tangents may differ.
+    static constexpr float INSTANCE_POSITION_TOLERANCE = 1e-4f;
+    static constexpr float INSTANCE_DIRECTION_TOLERANCE = 1e-3f;
+
+    [[nodiscard]] static VertexCacheStats analyze_vertex_cache(
+        std::span<const std::uint32_t> indices, std::size_t vertex_count
+    );
+
+    // Reorders the triangles for the vertex cache (Tipsify), then reorders clusters of them so
+    // that outward facing ones are drawn first, and finally reorders the vertices in the order
+    // they are first used for vertex fetch. Unused vertices are removed. Then the levels of detail
+    // are generated, each with half the triangles of the previous one, and the meshlets of every
+    // level are built from its final triangle order.
+    static MeshOptimizationReport optimize(MeshGeometry &mesh);
+    // Optimizes the meshes on the job system and logs the cache efficiency of each.
+    static void optimize_all(std::span<MeshGeometry> meshes, JobSystem &jobs);
+
+    // Finds the meshes that are translated copies of an earlier one, with the same indices,
+    // texture coordinates and directions, so that they can be drawn as instances of it. Candidates
+    // are found by hashing what a translation leaves unchanged and then compared vertex by vertex.
+    [[nodiscard]] static std::vector<MeshInstance> find_instances(
+        std::span<const MeshGeometry> meshes
+    );
+
+    // Splits the triangles into runs of at most MESHLET_TRIANGLES triangles that reference at
+    // most MESHLET_VERTICES vertices, without reordering them.
+    [[nodiscard]] static std::vector<Meshlet> build_meshlets(
+        std::span<const Mesh::Vertex> vertices, std::span<const std::uint32_t> indices
+    );
+
+  private:
+    // Returns the first triangle of every cluster that starts with a cold cache.
+    static std::vector<std::size_t> optimize_vertex_cache(
+        std::span<std::uint32_t> indices, std::size_t vertex_count
+    );
+    // Splits the clusters further wherever that costs less than OVERDRAW_THRESHOLD in ACMR.
+    static std::vector<std::size_t> split_clusters(
+        std::span<const std::uint32_t> indices, std::size_t vertex_count,
+        std::span<const std::size_t> clusters
+    );
+    static void optimize_overdraw(
+        std::span<std::uint32_t> indices, std::span<const Mesh::Vertex> vertices,
+        std::span<const std::size_t> clusters
+    );
+    static void optimize_vertex_fetch(MeshGeometry &mesh);
+    static void build_lods(MeshGeometry &mesh);
+    static void compute_meshlet_bounds(
+        Meshlet &meshlet, std::span<const Mesh::Vertex> vertices,
+        std::span<const std::uint32_t> indices
+    );
+};
+
+#endif // MESH_OPTIMIZER_H
@@ -0,0 +1,357 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace
+{
+std::uint64_t edge_key(const std::uint32_t a, const std::uint32_t b)
+{
+    return static_cast<std::uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+}
+
+struct PositionHash
+{
+    std::size_t operator()(const glm::vec3 &position) const
+    {
+        std::array<std::uint32_t, 3> bits{};
+        std::memcpy(bits.data(), &position, sizeof(bits));
+        return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+    }
+};
+} // namespace
+
+void MeshSimplifier::Quadric::add_plane(const glm::dvec4 &plane, const double weight)
+{
+    const auto [a, b, c, d] = std::array{plane.x, plane.y, plane.z, plane.w};
+    const std::array<double, 10> terms{
+        a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d,
+    };
+    for (std::size_t i = 0; i < m.size(); ++i)
+    {
+        m[i] += terms[i] * weight;
+    }
+    this->weight += weight;
+}
+
+MeshSimplifier::Quadric &MeshSimplifier::Quadric::operator+=(const Quadric &other)
+{
+    for (std::size_t i = 0; i < m.size(); ++i)
+    {
+        m[i] += other.m[i];
+    }
+    weight += other.weight;
+    return *this;
+}
+
+double MeshSimplifier::Quadric::error(const glm::dvec3 &point) const
+{
+    if (weight <= 0.0)
+    {
+        return 0.0;
+    }
+    const auto [x, y, z] = std::array{point.x, point.y, point.z};
+    const auto squared = m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z +
+                         2.0 * m[3] * x + m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y +
+                         m[7] * z * z + 2.0 * m[8] * z + m[9];
+    return std::sqrt(std::max(squared, 0.0) / weight);
+}
+
+MeshSimplifier::MeshSimplifier(
+    const std::span<const Mesh::Vertex> vertices, const std::span<const std::uint32_t> indices
+)
+    : m_vertices(vertices), m_indices(indices.begin(), indices.end()),
+      m_positions(vertices.size()), m_kinds(vertices.size(), VertexKind::Manifold),
+      m_quadrics(vertices.size())
+{
+    std::unordered_map<glm::vec3, std::uint32_t, PositionHash> first_vertex;
+    for (std::uint32_t i = 0; i < vertices.size(); ++i)
+    {
+        m_positions[i] = first_vertex.try_emplace(vertices[i].position, i).first->second;
+    }
+
+    classify_vertices();
+    compute_quadrics();
+}
+
+bool MeshSimplifier::simplify(const std::size_t target_index_count, const double max_error)
+{
+    const auto vertex_count = m_vertices.size();
+    auto collapsed = false;
+
+    // Every pass collapses as many edges as it can without two collapses touching the same
+    // triangle, so that the flip tests stay valid, and then rebuilds the index buffer.
+    while (m_indices.size() > target_index_count)
+    {
+        const auto triangle_count = m_indices.size() / 3;
+
+        std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+        for (const auto index : m_indices)
+        {
+            ++offsets[index + 1];
+        }
+        std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::uint32_t> adjacency(m_indices.size());
+        {
+            auto fill = offsets;
+            for (std::uint32_t t = 0; t < triangle_count; ++t)
+            {
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    adjacency[fill[m_indices[3 * t + k]]++] = t;
+                }
+            }
+        }
+
+        std::unordered_map<std::uint64_t, std::uint32_t> edge_counts;
+        for (std::size_t t = 0; t < triangle_count; ++t)
+        {
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                ++edge_counts[edge_key(
+                    m_positions[m_indices[3 * t + k]],
+                    m_positions[m_indices[3 * t + (k + 1) % 3]]
+                )];
+            }
+        }
+
+        std::vector<Collapse> collapses;
+        for (std::size_t t = 0; t < triangle_count; ++t)
+        {
+            for (std::size_t k = 0; k < 6; ++k)
+            {
+                const auto from = m_indices[3 * t + k % 3];
+                const auto to = m_indices[3 * t + (k % 3 + (k < 3 ? 1 : 2)) % 3];
+                const auto kind = m_kinds[from];
+                if (kind == VertexKind::Locked ||
+                    (kind == VertexKind::Border &&
+                     (m_kinds[to] == VertexKind::Manifold ||
+                      edge_counts[edge_key(m_positions[from], m_positions[to])] != 1)))
+                {
+                    continue;
+                }
+
+                auto quadric = m_quadrics[m_positions[from]];
+                quadric += m_quadrics[m_positions[to]];
+                const auto error = quadric.error(get_position(to));
+                if (error <= max_error)
+                {
+                    collapses.push_back(Collapse{.from = from, .to = to, .error = error});
+                }
+            }
+        }
+        std::ranges::sort(collapses, {}, &Collapse::error);
+
+        std::vector<std::uint32_t> remap(vertex_count);
+        std::iota(remap.begin(), remap.end(), 0);
+        std::vector<bool> locked(vertex_count, false);
+        const auto removable = (m_indices.size() - target_index_count + 2) / 3;
+        std::size_t removed = 0;
+        auto pass_collapsed = false;
+
+        for (const auto &[from, to, error] : collapses)
+        {
+            if (removed >= removable)
+            {
+                break;
+            }
+            if (locked[from] || locked[to])
+            {
+                continue;
+            }
+            const auto triangles =
+                std::span(adjacency).subspan(offsets[from], offsets[from + 1] - offsets[from]);
+            if (flips_triangles(from, to, triangles))
+            {
+                continue;
+            }
+
+            remap[from] = to;
+            m_quadrics[m_positions[to]] += m_quadrics[m_positions[from]];
+            m_error = std::max(m_error, error);
+            pass_collapsed = true;
+
+            for (const auto t : triangles)
+            {
+                auto removes = false;
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    const auto vertex = m_indices[3 * t + k];
+                    removes |= m_positions[vertex] == m_positions[to];
+                    locked[vertex] = true;
+                }
+                removed += removes;
+            }
+        }
+
+        if (!pass_collapsed)
+        {
+            break;
+        }
+        collapsed = true;
+
+        std::size_t output = 0;
+        for (std::size_t t = 0; t < triangle_count; ++t)
+        {
+            const auto a = remap[m_indices[3 * t]];
+            const auto b = remap[m_indices[3 * t + 1]];
+            const auto c = remap[m_indices[3 * t + 2]];
+            if (m_positions[a] == m_positions[b] || m_positions[b] == m_positions[c] ||
+                m_positions[c] == m_positions[a])
+            {
+                continue;
+            }
+            m_indices[output++] = a;
+            m_indices[output++] = b;
+            m_indices[output++] = c;
+        }
+        m_indices.resize(output);
+    }
+
+    return collapsed;
+}
+
+std::span<const std::uint32_t> MeshSimplifier::get_indices() const
+{
+    return m_indices;
+}
+
+double MeshSimplifier::get_error() const
+{
+    return m_error;
+}
+
+void MeshSimplifier::classify_vertices()
+{
+    for (std::uint32_t i = 0; i < m_vertices.size(); ++i)
+    {
+        if (m_positions[i] != i)
+        {
+            m_kinds[i] = VertexKind::Locked;
+            m_kinds[m_positions[i]] = VertexKind::Locked;
+        }
+    }
+
+    std::unordered_map<std::uint64_t, std::uint32_t> edge_counts;
+    for (std::size_t t = 0; t < m_indices.size() / 3; ++t)
+    {
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            ++edge_counts[edge_key(
+                m_positions[m_indices[3 * t + k]],
+                m_positions[m_indices[3 * t + (k + 1) % 3]]
+            )];
+        }
+    }
+    for (std::size_t t = 0; t < m_indices.size() / 3; ++t)
+    {
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            const auto a = m_indices[3 * t + k];
+            const auto b = m_indices[3 * t + (k + 1) % 3];
+            const auto count = edge_counts[edge_key(m_positions[a], m_positions[b])];
+            // Edges shared by more than two triangles are not simplified at all.
+            const auto kind = count > 2 ? VertexKind::Locked : VertexKind::Border;
+            if (count != 2)
+            {
+                for (const auto vertex : {a, b})
+                {
+                    if (m_kinds[vertex] != VertexKind::Locked)
+                    {
+                        m_kinds[vertex] = kind;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void MeshSimplifier::compute_quadrics()
+{
+    for (std::size_t t = 0; t < m_indices.size() / 3; ++t)
+    {
+        const std::array corners{m_indices[3 * t], m_indices[3 * t + 1], m_indices[3 * t + 2]};
+        const std::array positions{
+            get_position(corners[0]),
+            get_position(corners[1]),
+            get_position(corners[2]),
+        };
+        const auto normal = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+        const auto length = glm::length(normal);
+        if (length == 0.0)
+        {
+            continue;
+        }
+        const auto unit_normal = normal / length;
+        const auto plane = glm::dvec4(unit_normal, -glm::dot(unit_normal, positions[0]));
+        for (const auto corner : corners)
+        {
+            m_quadrics[m_positions[corner]].add_plane(plane, length * 0.5);
+        }
+
+        // Keep border vertices on the border with a plane through the edge, perpendicular to
+        // the triangle.
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            const auto a = corners[k];
+            const auto b = corners[(k + 1) % 3];
+            if (m_kinds[a] == VertexKind::Manifold || m_kinds[b] == VertexKind::Manifold)
+            {
+                continue;
+            }
+            const auto edge = positions[(k + 1) % 3] - positions[k];
+            const auto edge_normal = glm::cross(edge, unit_normal);
+            const auto edge_length = glm::length(edge_normal);
+            if (edge_length == 0.0)
+            {
+                continue;
+            }
+            const auto edge_unit_normal = edge_normal / edge_length;
+            const auto border_plane =
+                glm::dvec4(edge_unit_normal, -glm::dot(edge_unit_normal, positions[k]));
+            const auto weight = glm::dot(edge, edge) * BORDER_WEIGHT;
+            m_quadrics[m_positions[a]].add_plane(border_plane, weight);
+            m_quadrics[m_positions[b]].add_plane(border_plane, weight);
+        }
+    }
+}
+
+glm::dvec3 MeshSimplifier::get_position(const std::uint32_t vertex) const
+{
+    return glm::dvec3(m_vertices[vertex].position);
+}
+
+bool MeshSimplifier::flips_triangles(
+    const std::uint32_t from, const std::uint32_t to, const std::span<const std::uint32_t> triangles
+) const
+{
+    const auto target = get_position(to);
+    for (const auto t : triangles)
+    {
+        std::array<glm::dvec3, 3> before{};
+        std::array<glm::dvec3, 3> after{};
+        auto removed = false;
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            const auto vertex = m_indices[3 * t + k];
+            removed |= m_positions[vertex] == m_positions[to];
+            before[k] = get_position(vertex);
+            after[k] = vertex == from ? target : before[k];
+        }
+        if (removed)
+        {
+            continue;
+        }
+
+        const auto normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+        const auto normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+        if (glm::dot(normal_before, normal_after) <= 0.0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,90 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+
+// Simplifies a mesh by collapsing edges in the order of their quadric error (Garland and
+// Heckbert, "Surface Simplification Using Quadric Error Metrics", 1997). Every collapse moves a
+// vertex onto one of its neighbours, so the simplified indices still address the original
+// vertices and can share their buffer. Vertices on attribute seams are never moved, and vertices
+// on open borders only along the border.
+//
+// The quadrics keep accumulating across calls to `simplify`, so successive calls produce
+// successively coarser levels of detail whose error is measured against the original mesh.
+class MeshSimplifier
+{
+  public:
+    // How much more moving a border vertex off the border costs than moving a vertex off the
+    // surface by the same distance.
+    static constexpr double BORDER_WEIGHT = 10.0;
+
+  private:
+    // The symmetric 4x4 matrix of the sum of squared distances to a set of planes, weighted by
+    // the area of the triangles they come from.
+    struct Quadric
+    {
+        std::array<double, 10> m{};
+        double weight{};
+
+        void add_plane(const glm::dvec4 &plane, double weight);
+        Quadric &operator+=(const Quadric &other);
+        // The weighted root mean square distance of the point to the planes.
+        [[nodiscard]] double error(const glm::dvec3 &point) const;
+    };
+
+    enum class VertexKind : std::uint8_t
+    {
+        Manifold,
+        Border,
+        // Shares its position with other vertices, e.g. along a texture seam.
+        Locked,
+    };
+
+    struct Collapse
+    {
+        std::uint32_t from;
+        std::uint32_t to;
+        double error;
+    };
+
+    std::span<const Mesh::Vertex> m_vertices;
+    std::vector<std::uint32_t> m_indices;
+    // The first vertex with the same position as each vertex.
+    std::vector<std::uint32_t> m_positions;
+    std::vector<VertexKind> m_kinds;
+    std::vector<Quadric> m_quadrics;
+    double m_error{};
+
+  public:
+    explicit MeshSimplifier(
+        std::span<const Mesh::Vertex> vertices, std::span<const std::uint32_t> indices
+    );
+    MeshSimplifier(const MeshSimplifier &) = delete;
+    const MeshSimplifier &operator=(const MeshSimplifier &) = delete;
+
+    // Collapses edges until at most `target_index_count` indices are left or any further
+    // collapse would exceed `max_error`, in model units. Returns whether any edge was collapsed.
+    bool simplify(std::size_t target_index_count, double max_error);
+
+    [[nodiscard]] std::span<const std::uint32_t> get_indices() const;
+    // The largest error of any collapse so far.
+    [[nodiscard]] double get_error() const;
+
+  private:
+    void classify_vertices();
+    void compute_quadrics();
+    [[nodiscard]] glm::dvec3 get_position(std::uint32_t vertex) const;
+    // Whether moving `from` onto `to` would flip any of the triangles in `triangles`.
+    [[nodiscard]] bool flips_triangles(
+        std::uint32_t from, std::uint32_t to, std::span<const std::uint32_t> triangles
+    ) const;
+};
+
+#endif // MESH_SIMPLIFIER_H
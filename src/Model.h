@@ -1,13 +1,14 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
-#include "Mesh.h"
-#include "ShaderProgram.h"
-
 struct Transform
 {
     glm::vec3 m_position{0.0f, 0.0f, 0.0f};
@@ -25,17 +26,14 @@ struct Transform
 
 struct Model
 {
-    std::vector<Mesh> m_meshes;
+    // The model's nodes in the `SceneGraph`, a subtree of `m_node_count` nodes from `m_root` on.
+    // The transform is the local matrix of the root.
+    std::uint32_t m_root{};
+    std::uint32_t m_node_count{};
+    // Indices of the model's meshes in the `SceneGeometry` draw list. Meshes that are copies of
+    // another one are instances of its geometry.
+    std::vector<GLuint> m_draws;
     Transform m_transform;
-
-    void draw(ShaderProgram &program) const
-    {
-        program.set_uniform("model", m_transform.get_model_matrix());
-        for (const auto &mesh : m_meshes)
-        {
-            mesh.draw();
-        }
-    }
 };
 
 #endif // MODEL_H
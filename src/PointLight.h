@@ -1,8 +1,14 @@
 #ifndef POINTLIGHT_H
 #define POINTLIGHT_H
 
+#include <algorithm>
+#include <cmath>
+
+#include <glad/glad.h>
 #include <glm/glm.hpp>
 
+constexpr GLuint POINT_LIGHT_BINDING = 7;
+
 struct PointLight
 {
     glm::vec3 m_position;
@@ -13,6 +19,38 @@ struct PointLight
     float m_constant_attenuation;
     float m_linear_attenuation;
     float m_quadratic_attenuation;
+
+    // The distance at which the diffuse light falls below 1/256 of full intensity, beyond which
+    // the light is ignored.
+    [[nodiscard]] float get_radius() const
+    {
+        const auto threshold = 256.0f * std::max({m_diffuse.x, m_diffuse.y, m_diffuse.z});
+        if (m_quadratic_attenuation <= 0.0f)
+        {
+            return m_linear_attenuation > 0.0f
+                       ? (threshold - m_constant_attenuation) / m_linear_attenuation
+                       : 0.0f;
+        }
+        const auto discriminant = m_linear_attenuation * m_linear_attenuation -
+                                  4.0f * m_quadratic_attenuation *
+                                      (m_constant_attenuation - threshold);
+        return (-m_linear_attenuation + std::sqrt(std::max(discriminant, 0.0f))) /
+               (2.0f * m_quadratic_attenuation);
+    }
+};
+
+// Mirrors `PointLightData` in shaders/point_lights.glsl (std430).
+struct PointLightData
+{
+    glm::vec3 position;
+    float radius;
+    glm::vec3 ambient;
+    float constant_attenuation;
+    glm::vec3 diffuse;
+    float linear_attenuation;
+    glm::vec3 specular;
+    float quadratic_attenuation;
 };
+static_assert(sizeof(PointLightData) == 64);
 
 #endif // POINTLIGHT_H
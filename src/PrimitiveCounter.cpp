@@ -0,0 +1,47 @@
+#include "PrimitiveCounter.h"
+
+PrimitiveCounter::PrimitiveCounter()
+{
+    for (auto &query : m_queries)
+    {
+        query = QueryObject::create(GL_PRIMITIVES_GENERATED);
+    }
+}
+
+void PrimitiveCounter::begin()
+{
+    const auto next = (m_frame + 1) % m_queries.size();
+    const auto query = m_queries[next].get();
+
+    if (m_pending[next])
+    {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            return;
+        }
+        GLuint64 count = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &count);
+        m_count = count;
+    }
+
+    m_frame = next;
+    glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+    m_pending[next] = true;
+    m_active = true;
+}
+
+void PrimitiveCounter::end()
+{
+    if (m_active)
+    {
+        glEndQuery(GL_PRIMITIVES_GENERATED);
+        m_active = false;
+    }
+}
+
+std::uint64_t PrimitiveCounter::get_count() const
+{
+    return m_count;
+}
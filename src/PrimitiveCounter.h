@@ -0,0 +1,34 @@
+#ifndef PRIMITIVE_COUNTER_H
+#define PRIMITIVE_COUNTER_H
+
+#include <array>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include "GLObject.h"
+#include "RingBuffer.h"
+
+// Counts the primitives drawn by a range of commands with GL_PRIMITIVES_GENERATED queries. Like
+// GpuTimer, results are read a few frames later so that counting never stalls the pipeline.
+class PrimitiveCounter
+{
+    std::array<QueryObject, RingBuffer::FRAMES_IN_FLIGHT> m_queries;
+    std::array<bool, RingBuffer::FRAMES_IN_FLIGHT> m_pending{};
+    std::size_t m_frame{};
+    bool m_active{false};
+    std::uint64_t m_count{};
+
+  public:
+    explicit PrimitiveCounter();
+    PrimitiveCounter(const PrimitiveCounter &) = delete;
+    const PrimitiveCounter &operator=(const PrimitiveCounter &) = delete;
+
+    void begin();
+    void end();
+
+    // The last available result.
+    [[nodiscard]] std::uint64_t get_count() const;
+};
+
+#endif // PRIMITIVE_COUNTER_H
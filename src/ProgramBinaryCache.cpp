@@ -0,0 +1,225 @@
+#include "ProgramBinaryCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+constexpr std::uint32_t MAGIC = 0x43425053; // "SPBC"
+constexpr std::uint32_t FORMAT_VERSION = 1;
+// Far more than any program of the renderer, so that a corrupt size is not allocated.
+constexpr std::uint32_t MAX_BINARY_SIZE = 64 * 1024 * 1024;
+
+struct Header
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t key;
+    GLenum binary_format;
+    std::uint32_t size;
+    double compile_time;
+};
+
+std::uint64_t fnv1a(std::uint64_t hash, const std::string_view data)
+{
+    for (const auto c : data)
+    {
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string_view get_string(const GLenum name)
+{
+    const auto *string = reinterpret_cast<const char *>(glGetString(name));
+    return string ? std::string_view(string) : std::string_view();
+}
+} // namespace
+
+ProgramBinaryCache &ProgramBinaryCache::get()
+{
+    static ProgramBinaryCache cache;
+    return cache;
+}
+
+void ProgramBinaryCache::set_directory(std::filesystem::path directory)
+{
+    m_directory = std::move(directory);
+}
+
+bool ProgramBinaryCache::is_enabled()
+{
+    initialize();
+    return m_supported && !m_directory.empty();
+}
+
+std::uint64_t ProgramBinaryCache::make_key(const std::span<const std::string_view> parts)
+{
+    initialize();
+    auto hash = m_driver_hash;
+    for (const auto part : parts)
+    {
+        hash = fnv1a(hash, part);
+        // Separate the parts, so that moving text from one part to the next changes the key.
+        hash = fnv1a(hash, std::string_view("\0", 1));
+    }
+    return hash;
+}
+
+bool ProgramBinaryCache::load(const GLuint program, const std::uint64_t key)
+{
+    if (!is_enabled())
+    {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::ifstream file(get_path(key), std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        ++m_stats.misses;
+        return false;
+    }
+    const auto file_size = static_cast<std::uint64_t>(file.tellg());
+    file.seekg(0);
+
+    // The size is only trusted if the binary fills exactly the rest of the file.
+    Header header{};
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file || header.magic != MAGIC || header.version != FORMAT_VERSION ||
+        header.key != key || header.size > MAX_BINARY_SIZE ||
+        header.size != file_size - sizeof(header))
+    {
+        ++m_stats.misses;
+        return false;
+    }
+    std::vector<char> binary(header.size);
+    file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!file)
+    {
+        ++m_stats.misses;
+        return false;
+    }
+
+    glProgramBinary(
+        program,
+        header.binary_format,
+        binary.data(),
+        static_cast<GLsizei>(binary.size())
+    );
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        // E.g. after a driver update that did not change the version string.
+        ++m_stats.rejected;
+        ++m_stats.misses;
+        return false;
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto load_time = std::chrono::duration<double, std::milli>(elapsed).count();
+    ++m_stats.hits;
+    m_stats.load_time += load_time;
+    m_stats.time_saved += std::max(header.compile_time - load_time, 0.0);
+    return true;
+}
+
+void ProgramBinaryCache::store(
+    const GLuint program, const std::uint64_t key, const double compile_time
+)
+{
+    if (!is_enabled())
+    {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum binary_format;
+    glGetProgramBinary(program, length, &length, &binary_format, binary.data());
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    const auto path = get_path(key);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const Header header{
+        .magic = MAGIC,
+        .version = FORMAT_VERSION,
+        .key = key,
+        .binary_format = binary_format,
+        .size = static_cast<std::uint32_t>(length),
+        .compile_time = compile_time,
+    };
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(binary.data(), length);
+    if (!file)
+    {
+        spdlog::warn("failed to write program binary '{}'", path.string());
+    }
+}
+
+void ProgramBinaryCache::record_compile(const double compile_time)
+{
+    m_stats.compile_time += compile_time;
+}
+
+const ProgramBinaryCache::Stats &ProgramBinaryCache::get_stats() const
+{
+    return m_stats;
+}
+
+void ProgramBinaryCache::log_summary() const
+{
+    if (!m_supported)
+    {
+        spdlog::info("program binary cache: unsupported by the driver");
+        return;
+    }
+    spdlog::info(
+        "program binary cache: {} hits, {} misses ({} rejected), {:.1f} ms loading, {:.1f} ms "
+        "compiling, {:.1f} ms saved",
+        m_stats.hits,
+        m_stats.misses,
+        m_stats.rejected,
+        m_stats.load_time,
+        m_stats.compile_time,
+        m_stats.time_saved
+    );
+}
+
+void ProgramBinaryCache::initialize()
+{
+    if (m_initialized)
+    {
+        return;
+    }
+    m_initialized = true;
+
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    m_supported = format_count > 0;
+
+    m_driver_hash = 14695981039346656037ull;
+    for (const auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+    {
+        m_driver_hash = fnv1a(m_driver_hash, get_string(name));
+        m_driver_hash = fnv1a(m_driver_hash, std::string_view("\0", 1));
+    }
+}
+
+std::filesystem::path ProgramBinaryCache::get_path(const std::uint64_t key) const
+{
+    return m_directory / fmt::format("{:016x}.bin", key);
+}
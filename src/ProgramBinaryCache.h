@@ -0,0 +1,63 @@
+#ifndef PROGRAM_BINARY_CACHE_H
+#define PROGRAM_BINARY_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <glad/glad.h>
+
+// Stores linked program binaries on disk, keyed by a hash of the shader sources and the driver
+// vendor, renderer and version, so that later runs can skip compiling and linking.
+class ProgramBinaryCache
+{
+  public:
+    struct Stats
+    {
+        std::uint32_t hits{};
+        std::uint32_t misses{};
+        // Binaries that were found but not accepted by the driver.
+        std::uint32_t rejected{};
+        double load_time{};
+        double compile_time{};
+        // Compile time recorded with every hit minus the time it took to load it.
+        double time_saved{};
+    };
+
+  private:
+    std::filesystem::path m_directory{"./shader_cache"};
+    bool m_supported{false};
+    bool m_initialized{false};
+    std::uint64_t m_driver_hash{};
+    Stats m_stats;
+
+    explicit ProgramBinaryCache() = default;
+
+  public:
+    ProgramBinaryCache(const ProgramBinaryCache &) = delete;
+    const ProgramBinaryCache &operator=(const ProgramBinaryCache &) = delete;
+
+    static ProgramBinaryCache &get();
+
+    // An empty directory disables the cache.
+    void set_directory(std::filesystem::path directory);
+    [[nodiscard]] bool is_enabled();
+
+    [[nodiscard]] std::uint64_t make_key(std::span<const std::string_view> parts);
+
+    // Loads the binary stored under `key` into `program`. Returns whether the program is linked.
+    bool load(GLuint program, std::uint64_t key);
+    void store(GLuint program, std::uint64_t key, double compile_time);
+    void record_compile(double compile_time);
+
+    [[nodiscard]] const Stats &get_stats() const;
+    void log_summary() const;
+
+  private:
+    void initialize();
+    [[nodiscard]] std::filesystem::path get_path(std::uint64_t key) const;
+};
+
+#endif // PROGRAM_BINARY_CACHE_H
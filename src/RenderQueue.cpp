@@ -0,0 +1,416 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "GLState.h"
+
+namespace
+{
+constexpr int PASS_SHIFT = 62;
+constexpr int PROGRAM_SHIFT = 56;
+constexpr int MATERIAL_SHIFT = 40;
+constexpr int DEPTH_SHIFT = 16;
+constexpr int GEOMETRY_SHIFT = 24;
+
+constexpr std::uint64_t PROGRAM_MASK = 0x3f;
+constexpr std::uint64_t MATERIAL_MASK = 0xffff;
+constexpr std::uint64_t DEPTH_MASK = 0xffffff;
+} // namespace
+
+RenderQueue::RenderQueue(const SceneGeometry &geometry) : m_geometry(geometry)
+{
+}
+
+std::uint64_t RenderQueue::make_key(
+    const Pass pass, const std::uint8_t program, const std::uint32_t material, const float depth
+)
+{
+    const auto quantized_depth =
+        static_cast<std::uint64_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>(DEPTH_MASK));
+
+    return static_cast<std::uint64_t>(pass) << PASS_SHIFT |
+           (program & PROGRAM_MASK) << PROGRAM_SHIFT |
+           (material & MATERIAL_MASK) << MATERIAL_SHIFT | quantized_depth << DEPTH_SHIFT;
+}
+
+bool RenderQueue::needs_rebuild(const std::uint64_t scene_version) const
+{
+    return !m_valid || m_scene_version != scene_version;
+}
+
+void RenderQueue::invalidate()
+{
+    m_valid = false;
+}
+
+void RenderQueue::begin(const Pass pass, const glm::mat4 &view, const float z_far)
+{
+    m_pass = pass;
+    m_view = view;
+    m_z_far = z_far;
+    m_items.clear();
+}
+
+void RenderQueue::push(ShaderProgram &program, const GLuint draw, const GLuint lod)
+{
+    const auto program_index =
+        static_cast<std::size_t>(std::ranges::find(m_programs, &program) - m_programs.begin());
+    if (program_index == m_programs.size())
+    {
+        if (program_index > PROGRAM_MASK)
+        {
+            throw std::runtime_error("too many shader programs in render queue");
+        }
+        m_programs.push_back(&program);
+    }
+
+    const auto &data = m_geometry.get_draws()[draw];
+    const auto program_id = static_cast<std::uint8_t>(program_index);
+
+    std::uint64_t key;
+    if (m_pass == Pass::Geometry)
+    {
+        const auto center = m_view * data.model * glm::vec4(glm::vec3(data.bounds), 1.0f);
+        const auto depth = (-center.z - data.bounds.w) / m_z_far;
+        key = make_key(m_pass, program_id, data.material, depth);
+    }
+    else
+    {
+        key = static_cast<std::uint64_t>(m_pass) << PASS_SHIFT |
+              (program_id & PROGRAM_MASK) << PROGRAM_SHIFT |
+              static_cast<std::uint64_t>(data.lods[lod].first_index) << GEOMETRY_SHIFT;
+    }
+
+    m_items.push_back(Item{
+        .key = key,
+        .draw = draw,
+        .material = data.material,
+        .program = program_id,
+        .lod = static_cast<std::uint8_t>(lod),
+        .instance_group = 0,
+    });
+}
+
+void RenderQueue::end(const std::uint64_t scene_version, RingBuffer &ring)
+{
+    build();
+    upload(scene_version, ring);
+}
+
+void RenderQueue::build()
+{
+    sort();
+    build_commands();
+}
+
+void RenderQueue::upload(const std::uint64_t scene_version, RingBuffer &ring)
+{
+    const auto command_bytes =
+        static_cast<GLsizeiptr>(m_commands.size() * sizeof(DrawElementsIndirectCommand));
+    const auto draw_id_bytes = static_cast<GLsizeiptr>(m_draw_ids.size() * sizeof(GLuint));
+    if (!m_command_buffer || m_command_buffer->get_size() < command_bytes)
+    {
+        m_command_buffer.emplace(command_bytes);
+    }
+    if (!m_draw_id_buffer || m_draw_id_buffer->get_size() < draw_id_bytes)
+    {
+        m_draw_id_buffer.emplace(draw_id_bytes);
+    }
+    ring.stage(*m_command_buffer, 0, command_bytes, m_commands.data());
+    ring.stage(*m_draw_id_buffer, 0, draw_id_bytes, m_draw_ids.data());
+
+    m_valid = true;
+    m_scene_version = scene_version;
+    ++m_stats.rebuilds;
+}
+
+void RenderQueue::sort()
+{
+    // Material binds needed when submitting in push order, to report how many the sort saves.
+    m_unsorted_material_binds = 0;
+    auto material = ~0u;
+    for (const auto &item : m_items)
+    {
+        if (item.material != material)
+        {
+            ++m_unsorted_material_binds;
+            material = item.material;
+        }
+    }
+
+    if (m_sorting)
+    {
+        radix_sort();
+    }
+    if (m_instancing)
+    {
+        group_instances();
+    }
+}
+
+void RenderQueue::radix_sort()
+{
+    m_scratch.resize(m_items.size());
+
+    auto *source = &m_items;
+    auto *destination = &m_scratch;
+    for (auto shift = 0; shift < 64; shift += 8)
+    {
+        std::array<std::size_t, 256> histogram{};
+        for (const auto &item : *source)
+        {
+            ++histogram[(item.key >> shift) & 0xff];
+        }
+
+        // Skip the digit if every key shares it, which is the case for most of the high bits.
+        if (std::ranges::find(histogram, source->size()) != histogram.end())
+        {
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (auto &count : histogram)
+        {
+            const auto bucket_size = count;
+            count = offset;
+            offset += bucket_size;
+        }
+        for (const auto &item : *source)
+        {
+            (*destination)[histogram[(item.key >> shift) & 0xff]++] = item;
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != &m_items)
+    {
+        m_items.swap(m_scratch);
+    }
+}
+
+void RenderQueue::group_instances()
+{
+    const auto draws = m_geometry.get_draws();
+    const auto bind_materials = m_pass == Pass::Geometry;
+    std::unordered_map<std::uint64_t, GLuint> groups;
+
+    for (std::size_t begin = 0; begin < m_items.size();)
+    {
+        const auto &first = m_items[begin];
+        auto end = begin + 1;
+        while (end < m_items.size() && m_items[end].program == first.program &&
+               (!bind_materials || m_items[end].material == first.material))
+        {
+            ++end;
+        }
+
+        groups.clear();
+        for (auto i = begin; i < end; ++i)
+        {
+            auto &item = m_items[i];
+            const auto mesh = static_cast<std::uint64_t>(draws[item.draw].mesh) << 8 | item.lod;
+            item.instance_group = groups.try_emplace(mesh, static_cast<GLuint>(i)).first->second;
+        }
+        if (groups.size() < end - begin)
+        {
+            std::ranges::stable_sort(
+                std::span(m_items).subspan(begin, end - begin),
+                {},
+                &Item::instance_group
+            );
+        }
+        begin = end;
+    }
+}
+
+void RenderQueue::build_commands()
+{
+    m_commands.clear();
+    m_draw_ids.clear();
+    m_batches.clear();
+
+    const auto bind_materials = m_pass == Pass::Geometry;
+    const auto draws = m_geometry.get_draws();
+    for (const auto &item : m_items)
+    {
+        const auto &data = draws[item.draw];
+        const auto &lod = data.lods[item.lod];
+        const auto draw_id = static_cast<GLuint>(m_draw_ids.size());
+        m_draw_ids.push_back(item.draw);
+
+        auto *program = m_programs[item.program];
+        const auto material = bind_materials ? item.material : 0;
+        if (m_batches.empty() || m_batches.back().program != program ||
+            m_batches.back().material != material)
+        {
+            m_batches.push_back(Batch{
+                .program = program,
+                .material = material,
+                .offset = static_cast<GLuint>(m_commands.size()),
+                .count = 0,
+            });
+        }
+
+        // Grouped items follow each other, so an instance only has to match the previous item.
+        auto &batch = m_batches.back();
+        if (m_instancing && batch.count > 0 && m_commands.back().first_index == lod.first_index &&
+            m_commands.back().base_vertex == data.base_vertex)
+        {
+            ++m_commands.back().instance_count;
+            continue;
+        }
+        m_commands.push_back(DrawElementsIndirectCommand{
+            .count = lod.index_count,
+            .instance_count = 1,
+            .first_index = lod.first_index,
+            .base_vertex = data.base_vertex,
+            .base_instance = draw_id,
+        });
+        ++batch.count;
+    }
+
+    m_stats.draws = static_cast<GLuint>(m_items.size());
+    m_stats.commands = static_cast<GLuint>(m_commands.size());
+    m_stats.batches = static_cast<GLuint>(m_batches.size());
+    m_stats.program_binds = 0;
+    m_stats.material_binds = 0;
+    const ShaderProgram *previous_program = nullptr;
+    auto previous_material = ~0u;
+    for (const auto &batch : m_batches)
+    {
+        if (batch.program != previous_program)
+        {
+            ++m_stats.program_binds;
+            previous_program = batch.program;
+        }
+        if (bind_materials && batch.material != previous_material)
+        {
+            ++m_stats.material_binds;
+            previous_material = batch.material;
+        }
+    }
+    m_stats.material_binds_avoided =
+        bind_materials ? std::max(m_unsorted_material_binds, m_stats.material_binds) -
+                             m_stats.material_binds
+                       : 0;
+}
+
+void RenderQueue::record(
+    CommandList &commands, const std::span<const MaterialTextures> materials
+)
+{
+    m_geometry.bind(
+        commands,
+        m_pass == Pass::Shadow ? SceneGeometry::VertexStream::PositionOnly
+                               : SceneGeometry::VertexStream::Full
+    );
+    commands.bind_buffer(GL_DRAW_INDIRECT_BUFFER, m_command_buffer->get_handle());
+    commands.bind_buffer_base(
+        GL_SHADER_STORAGE_BUFFER,
+        SceneGeometry::DRAW_ID_BINDING,
+        m_draw_id_buffer->get_handle()
+    );
+
+    const auto bind_materials = m_pass == Pass::Geometry && !materials.empty();
+
+    const auto query = m_statistics_supported && !m_statistics_pending;
+    if (query)
+    {
+        commands.begin_query(GL_FRAGMENT_SHADER_INVOCATIONS, m_statistics_query.get());
+    }
+
+    const ShaderProgram *program = nullptr;
+    auto material = ~0u;
+    for (const auto &batch : m_batches)
+    {
+        if (batch.program != program)
+        {
+            program = batch.program;
+            commands.use_program(*batch.program);
+        }
+        if (bind_materials && batch.material != material)
+        {
+            material = batch.material;
+            commands.bind_texture(0, GL_TEXTURE_2D, materials[material].diffuse);
+            commands.bind_texture(1, GL_TEXTURE_2D, materials[material].normal);
+        }
+
+        commands.multi_draw_elements_indirect(
+            GL_TRIANGLES,
+            m_geometry.get_index_type(),
+            static_cast<GLintptr>(batch.offset * sizeof(DrawElementsIndirectCommand)),
+            static_cast<GLsizei>(batch.count)
+        );
+    }
+
+    if (query)
+    {
+        commands.end_query(GL_FRAGMENT_SHADER_INVOCATIONS);
+        m_statistics_pending = true;
+        m_statistics_sorted = m_sorting;
+    }
+}
+
+void RenderQueue::set_sorting(const bool sorting)
+{
+    if (sorting != m_sorting)
+    {
+        m_sorting = sorting;
+        m_valid = false;
+    }
+}
+
+bool RenderQueue::is_sorting() const
+{
+    return m_sorting;
+}
+
+void RenderQueue::set_instancing(const bool instancing)
+{
+    if (instancing != m_instancing)
+    {
+        m_instancing = instancing;
+        m_valid = false;
+    }
+}
+
+bool RenderQueue::is_instancing() const
+{
+    return m_instancing;
+}
+
+void RenderQueue::enable_fragment_statistics()
+{
+    if (!m_statistics_query)
+    {
+        m_statistics_query = QueryObject::create(GL_FRAGMENT_SHADER_INVOCATIONS);
+    }
+    m_statistics_supported = true;
+}
+
+const RenderQueue::Stats &RenderQueue::get_stats() const
+{
+    return m_stats;
+}
+
+void RenderQueue::read_fragment_statistics()
+{
+    if (!m_statistics_pending)
+    {
+        return;
+    }
+
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(m_statistics_query.get(), GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE)
+    {
+        return;
+    }
+
+    GLuint64 invocations = 0;
+    glGetQueryObjectui64v(m_statistics_query.get(), GL_QUERY_RESULT, &invocations);
+    m_stats.fragment_invocations[m_statistics_sorted ? 1 : 0] = invocations;
+    m_statistics_pending = false;
+}
@@ -0,0 +1,155 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Buffer.h"
+#include "CommandList.h"
+#include "GLObject.h"
+#include "Material.h"
+#include "RingBuffer.h"
+#include "SceneGeometry.h"
+#include "ShaderProgram.h"
+
+// Collects the draws of one pass, orders them by a 64-bit sort key and records them as
+// `glMultiDrawElementsIndirect` batches, one per run of draws sharing program and material.
+// Within a batch, draws of the same mesh and level of detail are grouped behind the first of them
+// and submitted as the instances of one command, which find their draws at its base instance.
+// The sorted list, its indirect commands and its batches are retained on the GPU, so as long as
+// nothing invalidates the list a frame only replays the batches.
+//
+// Key layout (most significant bits first):
+//   pass     [63:62]
+//   program  [61:56]
+//   Geometry pass: material [55:40], front-to-back depth [39:16]
+//   Shadow pass:   first index of the mesh LOD [55:24], i.e. ordered by position in the buffers
+class RenderQueue
+{
+  public:
+    enum class Pass : std::uint8_t
+    {
+        Shadow = 0,
+        Geometry = 1,
+    };
+
+    struct Stats
+    {
+        GLuint draws{};
+        // Indirect commands the draws were merged into by instancing.
+        GLuint commands{};
+        GLuint batches{};
+        GLuint rebuilds{};
+        GLuint program_binds{};
+        GLuint material_binds{};
+        // Material binds that submitting in push order would have needed on top of this.
+        GLuint material_binds_avoided{};
+        // Fragment shader invocations of the last finished frame, per ordering (unsorted,
+        // sorted). Comparing the two shows how much early-Z rejects thanks to the ordering.
+        std::array<std::uint64_t, 2> fragment_invocations{};
+    };
+
+  private:
+    struct Item
+    {
+        std::uint64_t key;
+        GLuint draw;
+        GLuint material;
+        std::uint8_t program;
+        std::uint8_t lod;
+        // The first item of the batch with the same mesh and level of detail.
+        GLuint instance_group;
+    };
+
+    struct Batch
+    {
+        ShaderProgram *program;
+        GLuint material;
+        GLuint offset;
+        GLuint count;
+    };
+
+    const SceneGeometry &m_geometry;
+
+    Pass m_pass{Pass::Geometry};
+    glm::mat4 m_view{1.0f};
+    float m_z_far{1.0f};
+    bool m_sorting{true};
+    bool m_instancing{true};
+    GLuint m_unsorted_material_binds{};
+
+    std::vector<ShaderProgram *> m_programs;
+    std::vector<Item> m_items;
+    std::vector<Item> m_scratch;
+    std::vector<DrawElementsIndirectCommand> m_commands;
+    std::vector<GLuint> m_draw_ids;
+    std::vector<Batch> m_batches;
+
+    bool m_valid{false};
+    std::uint64_t m_scene_version{};
+
+    std::optional<Buffer> m_command_buffer;
+    std::optional<Buffer> m_draw_id_buffer;
+
+    bool m_statistics_supported{false};
+    QueryObject m_statistics_query;
+    bool m_statistics_pending{false};
+    bool m_statistics_sorted{false};
+
+    Stats m_stats;
+
+  public:
+    explicit RenderQueue(const SceneGeometry &geometry);
+    RenderQueue(const RenderQueue &) = delete;
+    const RenderQueue &operator=(const RenderQueue &) = delete;
+
+    // Whether the list has to be recorded again, because it was invalidated or because the
+    // structure of the scene changed since it was recorded.
+    [[nodiscard]] bool needs_rebuild(std::uint64_t scene_version) const;
+    void invalidate();
+
+    // `view` and `z_far` are used to compute the depth part of the key of geometry pass draws.
+    void begin(Pass pass, const glm::mat4 &view = glm::mat4(1.0f), float z_far = 1.0f);
+    void push(ShaderProgram &program, GLuint draw, GLuint lod = 0);
+    // Sorts the draws and uploads the indirect commands through `ring`.
+    void end(std::uint64_t scene_version, RingBuffer &ring);
+    // `end` in two parts: `build` sorts the draws and builds the indirect commands without
+    // touching GL, so that queues can be recorded on other threads, and `upload` has to run on
+    // the GL thread afterwards.
+    void build();
+    void upload(std::uint64_t scene_version, RingBuffer &ring);
+
+    // Records the commands that draw the queue. Touches no GL state, so the queues of several
+    // passes can be recorded on different threads, after `read_fragment_statistics` ran on the
+    // GL thread.
+    void record(CommandList &commands, std::span<const MaterialTextures> materials = {});
+    // Picks up the fragment shader invocations of an earlier frame once they are available.
+    void read_fragment_statistics();
+
+    void set_sorting(bool sorting);
+    [[nodiscard]] bool is_sorting() const;
+    void set_instancing(bool instancing);
+    [[nodiscard]] bool is_instancing() const;
+    void enable_fragment_statistics();
+
+    [[nodiscard]] const Stats &get_stats() const;
+
+    [[nodiscard]] static std::uint64_t
+    make_key(Pass pass, std::uint8_t program, std::uint32_t material, float depth);
+
+  private:
+    void sort();
+    void radix_sort();
+    // Moves the items of every batch behind the first one with the same mesh and level of
+    // detail, keeping the groups in the order of their first item.
+    void group_instances();
+    void build_commands();
+};
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,215 @@
+#ifndef RESOURCE_POOL_H
+#define RESOURCE_POOL_H
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+// A reference to a resource in a ResourcePool, packed into 32 bits: the index of the resource's
+// slot and the generation of the slot, which changes when the resource is destroyed, so that an
+// old handle is not mistaken for the resource that reuses its slot.
+template <typename T> class Handle
+{
+  public:
+    static constexpr std::uint32_t INDEX_BITS = 20;
+    static constexpr std::uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr std::uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+  private:
+    static constexpr std::uint32_t INVALID = ~0u;
+
+    std::uint32_t m_value{INVALID};
+
+    template <typename> friend class ResourcePool;
+
+    explicit Handle(const std::uint32_t index, const std::uint32_t generation)
+        : m_value(generation << INDEX_BITS | index)
+    {
+    }
+
+  public:
+    Handle() = default;
+
+    [[nodiscard]] bool is_valid() const
+    {
+        return m_value != INVALID;
+    }
+
+    [[nodiscard]] std::uint32_t get_index() const
+    {
+        return m_value & INDEX_MASK;
+    }
+
+    [[nodiscard]] std::uint32_t get_generation() const
+    {
+        return m_value >> INDEX_BITS;
+    }
+
+    bool operator==(const Handle &) const = default;
+};
+
+enum class ResourceState
+{
+    // The handle is invalid or its resource was destroyed.
+    Missing,
+    Resident,
+    // Released, but kept alive until the GPU has finished the frames that might still use it.
+    Releasing,
+};
+
+// Resources of one type stored densely in a vector, found through a slot per handle. Destroying a
+// resource moves the last one into its place, so the resources stay contiguous.
+template <typename T> class ResourcePool
+{
+    static constexpr std::uint32_t NO_RESOURCE = ~0u;
+    static constexpr std::uint64_t NOT_RELEASED = ~0ull;
+
+    struct Slot
+    {
+        std::uint32_t generation{};
+        // Index into m_resources, NO_RESOURCE while the slot is free.
+        std::uint32_t resource{NO_RESOURCE};
+        // The frame in which the resource was released.
+        std::uint64_t release_frame{NOT_RELEASED};
+    };
+
+    std::vector<T> m_resources;
+    // The slot of every resource, to update it when the resource moves.
+    std::vector<std::uint32_t> m_resource_slots;
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_free_slots;
+    std::vector<std::uint32_t> m_released_slots;
+
+  public:
+    explicit ResourcePool() = default;
+    ResourcePool(const ResourcePool &) = delete;
+    const ResourcePool &operator=(const ResourcePool &) = delete;
+
+    Handle<T> add(T resource)
+    {
+        std::uint32_t index;
+        if (!m_free_slots.empty())
+        {
+            index = m_free_slots.back();
+            m_free_slots.pop_back();
+        }
+        else
+        {
+            // The last index with the last generation is the invalid handle.
+            if (m_slots.size() >= Handle<T>::INDEX_MASK)
+            {
+                throw std::runtime_error(
+                    fmt::format("resource pool is full ({} resources)", m_slots.size())
+                );
+            }
+            index = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+
+        auto &slot = m_slots[index];
+        slot.resource = static_cast<std::uint32_t>(m_resources.size());
+        m_resources.push_back(std::move(resource));
+        m_resource_slots.push_back(index);
+        return Handle<T>(index, slot.generation);
+    }
+
+    // Marks the resource to be destroyed by the first `collect` that has seen `frame` complete.
+    // The resource can still be looked up until then.
+    void release(const Handle<T> handle, const std::uint64_t frame)
+    {
+        auto &slot = m_slots[check(handle)];
+        if (slot.release_frame == NOT_RELEASED)
+        {
+            slot.release_frame = frame;
+            m_released_slots.push_back(handle.get_index());
+        }
+    }
+
+    // Destroys the released resources whose frames have completed, up to and including
+    // `completed_frame`.
+    void collect(const std::uint64_t completed_frame)
+    {
+        std::erase_if(m_released_slots, [&](const std::uint32_t index) {
+            if (m_slots[index].release_frame > completed_frame)
+            {
+                return false;
+            }
+            destroy(index);
+            return true;
+        });
+    }
+
+    [[nodiscard]] ResourceState get_state(const Handle<T> handle) const
+    {
+        if (!contains(handle))
+        {
+            return ResourceState::Missing;
+        }
+        return m_slots[handle.get_index()].release_frame == NOT_RELEASED
+                   ? ResourceState::Resident
+                   : ResourceState::Releasing;
+    }
+
+    [[nodiscard]] bool contains(const Handle<T> handle) const
+    {
+        const auto index = handle.get_index();
+        return handle.is_valid() && index < m_slots.size() &&
+               m_slots[index].resource != NO_RESOURCE &&
+               m_slots[index].generation == handle.get_generation();
+    }
+
+    [[nodiscard]] T &get(const Handle<T> handle)
+    {
+        return m_resources[m_slots[check(handle)].resource];
+    }
+
+    [[nodiscard]] const T &get(const Handle<T> handle) const
+    {
+        return m_resources[m_slots[check(handle)].resource];
+    }
+
+    // All resources, in no particular order.
+    [[nodiscard]] std::span<const T> get_resources() const
+    {
+        return m_resources;
+    }
+
+  private:
+    std::uint32_t check(const Handle<T> handle) const
+    {
+        if (!contains(handle))
+        {
+            throw std::runtime_error(fmt::format(
+                "stale resource handle (slot {}, generation {})",
+                handle.get_index(),
+                handle.get_generation()
+            ));
+        }
+        return handle.get_index();
+    }
+
+    void destroy(const std::uint32_t index)
+    {
+        auto &slot = m_slots[index];
+        const auto last = static_cast<std::uint32_t>(m_resources.size() - 1);
+        if (slot.resource != last)
+        {
+            m_resources[slot.resource] = std::move(m_resources[last]);
+            m_resource_slots[slot.resource] = m_resource_slots[last];
+            m_slots[m_resource_slots[last]].resource = slot.resource;
+        }
+        m_resources.pop_back();
+        m_resource_slots.pop_back();
+
+        slot.resource = NO_RESOURCE;
+        slot.release_frame = NOT_RELEASED;
+        slot.generation = (slot.generation + 1) & Handle<T>::GENERATION_MASK;
+        m_free_slots.push_back(index);
+    }
+};
+
+#endif // RESOURCE_POOL_H
@@ -0,0 +1,78 @@
+#include "ResourceRegistry.h"
+
+#include <utility>
+
+#include "RingBuffer.h"
+
+TextureHandle ResourceRegistry::add_texture(Texture texture)
+{
+    return m_textures.add(std::move(texture));
+}
+
+TextureHandle ResourceRegistry::load_texture(const std::string &filename, const bool is_srgb)
+{
+    const auto found = m_texture_files.find(filename);
+    if (found != m_texture_files.end() && m_textures.contains(found->second))
+    {
+        return found->second;
+    }
+
+    const auto texture = add_texture(Texture::from_file_2d(filename, is_srgb));
+    m_texture_files.insert_or_assign(filename, texture);
+    return texture;
+}
+
+MaterialHandle ResourceRegistry::add_material(const Material &material)
+{
+    return m_materials.add(material);
+}
+
+void ResourceRegistry::release(const TextureHandle texture)
+{
+    m_textures.release(texture, m_frame);
+}
+
+void ResourceRegistry::release(const MaterialHandle material)
+{
+    m_materials.release(material, m_frame);
+}
+
+void ResourceRegistry::begin_frame()
+{
+    ++m_frame;
+    if (m_frame >= RingBuffer::FRAMES_IN_FLIGHT)
+    {
+        const auto completed_frame = m_frame - RingBuffer::FRAMES_IN_FLIGHT;
+        m_materials.collect(completed_frame);
+        m_textures.collect(completed_frame);
+    }
+}
+
+Texture &ResourceRegistry::get(const TextureHandle texture)
+{
+    return m_textures.get(texture);
+}
+
+const Material &ResourceRegistry::get(const MaterialHandle material) const
+{
+    return m_materials.get(material);
+}
+
+ResourceState ResourceRegistry::get_state(const TextureHandle texture) const
+{
+    return m_textures.get_state(texture);
+}
+
+ResourceState ResourceRegistry::get_state(const MaterialHandle material) const
+{
+    return m_materials.get_state(material);
+}
+
+MaterialTextures ResourceRegistry::get_textures(const MaterialHandle material) const
+{
+    const auto &[diffuse, normal] = m_materials.get(material);
+    return MaterialTextures{
+        .diffuse = m_textures.get(diffuse).get_handle(),
+        .normal = m_textures.get(normal).get_handle(),
+    };
+}
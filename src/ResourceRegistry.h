@@ -0,0 +1,45 @@
+#ifndef RESOURCE_REGISTRY_H
+#define RESOURCE_REGISTRY_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "Material.h"
+#include "ResourcePool.h"
+#include "Texture.h"
+
+// Owns the textures and materials of the scene, referenced by handles. Released resources are
+// destroyed once the GPU has finished every frame that might still use them.
+class ResourceRegistry
+{
+    ResourcePool<Texture> m_textures;
+    ResourcePool<Material> m_materials;
+    std::unordered_map<std::string, TextureHandle> m_texture_files;
+    std::uint64_t m_frame{};
+
+  public:
+    explicit ResourceRegistry() = default;
+    ResourceRegistry(const ResourceRegistry &) = delete;
+    const ResourceRegistry &operator=(const ResourceRegistry &) = delete;
+
+    TextureHandle add_texture(Texture texture);
+    // Loads a 2D texture, or returns the one already loaded from the same file.
+    TextureHandle load_texture(const std::string &filename, bool is_srgb = true);
+    MaterialHandle add_material(const Material &material);
+
+    // The resource stays usable until the GPU has finished the current frame.
+    void release(TextureHandle texture);
+    void release(MaterialHandle material);
+    // Destroys the resources whose last frame has completed. Call after RingBuffer::begin_frame,
+    // which has waited for the frames that are no longer in flight.
+    void begin_frame();
+
+    [[nodiscard]] Texture &get(TextureHandle texture);
+    [[nodiscard]] const Material &get(MaterialHandle material) const;
+    [[nodiscard]] ResourceState get_state(TextureHandle texture) const;
+    [[nodiscard]] ResourceState get_state(MaterialHandle material) const;
+    [[nodiscard]] MaterialTextures get_textures(MaterialHandle material) const;
+};
+
+#endif // RESOURCE_REGISTRY_H
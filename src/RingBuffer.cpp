@@ -0,0 +1,172 @@
+#include "RingBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "GLState.h"
+
+namespace
+{
+constexpr GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+constexpr GLuint64 WAIT_TIMEOUT = 1'000'000; // 1 ms
+
+GLsizeiptr get_alignment(const GLenum parameter)
+{
+    GLint alignment = 1;
+    glGetIntegerv(parameter, &alignment);
+    return std::max(alignment, 1);
+}
+} // namespace
+
+RingBuffer::RingBuffer(const GLsizeiptr frame_size)
+    : m_frame_size(frame_size),
+      m_buffer(frame_size * static_cast<GLsizeiptr>(FRAMES_IN_FLIGHT), nullptr, MAP_FLAGS),
+      m_data(static_cast<std::byte *>(
+          glMapNamedBufferRange(m_buffer.get_handle(), 0, m_buffer.get_size(), MAP_FLAGS)
+      )),
+      m_uniform_alignment(get_alignment(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)),
+      m_storage_alignment(get_alignment(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT))
+{
+    if (!m_data)
+    {
+        throw std::runtime_error("failed to map ring buffer");
+    }
+}
+
+RingBuffer::~RingBuffer()
+{
+    for (const auto fence : m_fences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+        }
+    }
+    glUnmapNamedBuffer(m_buffer.get_handle());
+}
+
+void RingBuffer::begin_frame()
+{
+    m_frame = (m_frame + 1) % FRAMES_IN_FLIGHT;
+    m_head = 0;
+    m_stats.last_wait_time = 0.0;
+
+    auto &fence = m_fences[m_frame];
+    if (!fence)
+    {
+        return;
+    }
+
+    // Poll first, so that frames that do not have to wait are not counted as stalls.
+    auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        ++m_stats.stalls;
+        const auto start = std::chrono::steady_clock::now();
+        do
+        {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        m_stats.last_wait_time = std::chrono::duration<double, std::micro>(elapsed).count();
+        m_stats.total_wait_time += m_stats.last_wait_time;
+    }
+    if (result == GL_WAIT_FAILED)
+    {
+        throw std::runtime_error("failed to wait for ring buffer fence");
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void RingBuffer::end_frame()
+{
+    m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_stats.used = m_head;
+    m_stats.high_water_mark = std::max(m_stats.high_water_mark, m_head);
+}
+
+RingBuffer::Allocation RingBuffer::allocate(const GLsizeiptr size, const GLsizeiptr alignment)
+{
+    const auto offset = (m_head + alignment - 1) / alignment * alignment;
+    if (offset + size > m_frame_size)
+    {
+        throw std::runtime_error(fmt::format(
+            "ring buffer allocation of {} bytes exceeds the {} bytes available per frame",
+            size,
+            m_frame_size
+        ));
+    }
+    m_head = offset + size;
+
+    const auto buffer_offset = static_cast<GLsizeiptr>(m_frame) * m_frame_size + offset;
+    return Allocation{
+        .buffer = m_buffer.get_handle(),
+        .offset = buffer_offset,
+        .size = size,
+        .data = m_data + buffer_offset,
+    };
+}
+
+RingBuffer::Allocation RingBuffer::allocate_uniform(const GLsizeiptr size)
+{
+    return allocate(size, m_uniform_alignment);
+}
+
+RingBuffer::Allocation RingBuffer::allocate_storage(const GLsizeiptr size)
+{
+    return allocate(size, m_storage_alignment);
+}
+
+void RingBuffer::push_uniform(const GLuint index, const void *data, const GLsizeiptr size)
+{
+    const auto allocation = allocate_uniform(size);
+    std::memcpy(allocation.data, data, size);
+    GLState::get().bind_buffer_range(
+        GL_UNIFORM_BUFFER,
+        index,
+        allocation.buffer,
+        allocation.offset,
+        allocation.size
+    );
+}
+
+void RingBuffer::stage(
+    Buffer &destination, const GLintptr offset, const GLsizeiptr size, const void *data
+)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    if ((m_head + 15) / 16 * 16 + size > m_frame_size)
+    {
+        // Too large for what is left of the frame, e.g. the first upload of a large scene.
+        destination.upload(offset, size, data);
+        return;
+    }
+    const auto allocation = allocate(size, 16);
+    std::memcpy(allocation.data, data, size);
+    glCopyNamedBufferSubData(
+        allocation.buffer,
+        destination.get_handle(),
+        allocation.offset,
+        offset,
+        size
+    );
+}
+
+const RingBuffer::Stats &RingBuffer::get_stats() const
+{
+    return m_stats;
+}
+
+GLsizeiptr RingBuffer::get_frame_size() const
+{
+    return m_frame_size;
+}
@@ -0,0 +1,76 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <array>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include "Buffer.h"
+
+// A persistently mapped buffer split into one region per frame in flight. Every frame allocates
+// from its own region, which is only written again after the fence of the frame that last used it
+// has signalled.
+class RingBuffer
+{
+  public:
+    static constexpr std::size_t FRAMES_IN_FLIGHT = 3;
+
+    struct Allocation
+    {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+        void *data;
+    };
+
+    struct Stats
+    {
+        // Frames that had to wait for the GPU before their region could be reused.
+        std::uint64_t stalls{};
+        double last_wait_time{};
+        double total_wait_time{};
+        GLsizeiptr used{};
+        GLsizeiptr high_water_mark{};
+    };
+
+  private:
+    GLsizeiptr m_frame_size;
+    Buffer m_buffer;
+    std::byte *m_data;
+    GLsizeiptr m_uniform_alignment;
+    GLsizeiptr m_storage_alignment;
+
+    std::array<GLsync, FRAMES_IN_FLIGHT> m_fences{};
+    std::size_t m_frame{};
+    GLsizeiptr m_head{};
+
+    Stats m_stats;
+
+  public:
+    explicit RingBuffer(GLsizeiptr frame_size);
+    RingBuffer(const RingBuffer &) = delete;
+    const RingBuffer &operator=(const RingBuffer &) = delete;
+    ~RingBuffer();
+
+    // Waits until the region of the next frame is no longer read by the GPU.
+    void begin_frame();
+    // Fences the commands that read the current region.
+    void end_frame();
+
+    [[nodiscard]] Allocation allocate(GLsizeiptr size, GLsizeiptr alignment);
+    [[nodiscard]] Allocation allocate_uniform(GLsizeiptr size);
+    [[nodiscard]] Allocation allocate_storage(GLsizeiptr size);
+
+    // Copies `data` into the ring and binds it to the indexed uniform buffer binding.
+    void push_uniform(GLuint index, const void *data, GLsizeiptr size);
+    // Copies `data` into the ring and from there into `destination` on the GPU, so the upload
+    // neither stalls nor needs the destination to be mapped. Data that does not fit into the rest
+    // of the frame is uploaded with `Buffer::upload` instead.
+    void stage(Buffer &destination, GLintptr offset, GLsizeiptr size, const void *data);
+
+    [[nodiscard]] const Stats &get_stats() const;
+    [[nodiscard]] GLsizeiptr get_frame_size() const;
+};
+
+#endif // RING_BUFFER_H
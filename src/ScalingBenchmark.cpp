@@ -0,0 +1,106 @@
+#include "ScalingBenchmark.h"
+
+#include <spdlog/spdlog.h>
+
+void ScalingBenchmark::start(const int max_instances)
+{
+    m_run = 0;
+    m_frame = 0;
+    m_max_instances = max_instances;
+    m_sum = Result{.instances = INSTANCE_COUNTS[0]};
+    m_results.clear();
+    m_results.reserve(INSTANCE_COUNTS.size());
+    m_finished = false;
+}
+
+bool ScalingBenchmark::is_running() const
+{
+    return m_run >= 0;
+}
+
+bool ScalingBenchmark::is_finished() const
+{
+    return m_finished;
+}
+
+int ScalingBenchmark::get_instance_count() const
+{
+    return is_running() ? INSTANCE_COUNTS[m_run] : 0;
+}
+
+void ScalingBenchmark::record(
+    const double frame_milliseconds, const double gpu_milliseconds, const std::uint64_t triangles
+)
+{
+    if (!is_running())
+    {
+        return;
+    }
+
+    if (m_frame++ >= WARMUP_FRAMES)
+    {
+        m_sum.frame_milliseconds += frame_milliseconds;
+        m_sum.gpu_milliseconds += gpu_milliseconds;
+        m_sum.triangles += static_cast<double>(triangles);
+        const auto &tracker = AllocationTracker::get();
+        for (std::size_t i = 0; i < AllocationTracker::PHASE_COUNT; ++i)
+        {
+            const auto &frame = tracker.get_last_frame(static_cast<FramePhase>(i));
+            m_sum.allocations[i].allocations += frame.allocations;
+            m_sum.allocations[i].bytes += frame.bytes;
+        }
+    }
+    if (m_frame < WARMUP_FRAMES + MEASURED_FRAMES)
+    {
+        return;
+    }
+
+    m_sum.frame_milliseconds /= MEASURED_FRAMES;
+    m_sum.gpu_milliseconds /= MEASURED_FRAMES;
+    m_sum.triangles /= MEASURED_FRAMES;
+    spdlog::info(
+        "scaling benchmark, {} instances: {:.3f} ms per frame, {:.3f} ms GPU, {:.3f} M triangles",
+        m_sum.instances,
+        m_sum.frame_milliseconds,
+        m_sum.gpu_milliseconds,
+        m_sum.triangles / 1e6
+    );
+    if (AllocationTracker::is_enabled())
+    {
+        for (std::size_t i = 0; i < AllocationTracker::PHASE_COUNT; ++i)
+        {
+            const auto &counter = m_sum.allocations[i];
+            spdlog::info(
+                "scaling benchmark, {} instances: {:.1f} allocations, {:.0f} bytes per frame in {}",
+                m_sum.instances,
+                static_cast<double>(counter.allocations) / MEASURED_FRAMES,
+                static_cast<double>(counter.bytes) / MEASURED_FRAMES,
+                AllocationTracker::get_phase_name(static_cast<FramePhase>(i))
+            );
+        }
+    }
+    m_results.push_back(m_sum);
+
+    m_frame = 0;
+    ++m_run;
+    const auto last = m_run == static_cast<int>(INSTANCE_COUNTS.size());
+    if (last || INSTANCE_COUNTS[m_run] > m_max_instances)
+    {
+        if (!last)
+        {
+            spdlog::warn(
+                "scaling benchmark: the scene has only {} instances, larger counts were skipped",
+                m_max_instances
+            );
+        }
+        m_run = -1;
+        m_finished = true;
+        return;
+    }
+    m_sum = Result{.instances = INSTANCE_COUNTS[m_run]};
+}
+
+const std::vector<ScalingBenchmark::Result> &ScalingBenchmark::get_results() const
+{
+    return m_results;
+}
@@ -0,0 +1,62 @@
+#ifndef SCALING_BENCHMARK_H
+#define SCALING_BENCHMARK_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "AllocationTracker.h"
+#include "RingBuffer.h"
+
+// Measures how the frame time grows with the size of the scene, by drawing the first 1, 4, 16, 64
+// and 256 instances of the stress scene at the current view, over a fixed number of frames each.
+// Counts larger than the scene are skipped.
+class ScalingBenchmark
+{
+  public:
+    static constexpr std::array<int, 5> INSTANCE_COUNTS{1, 4, 16, 64, 256};
+    // GPU queries are read a few frames late, and the draw lists of a new count are built on its
+    // first frame.
+    static constexpr int WARMUP_FRAMES = 2 * RingBuffer::FRAMES_IN_FLIGHT;
+    static constexpr int MEASURED_FRAMES = 120;
+
+    struct Result
+    {
+        int instances{};
+        // Averages per frame.
+        double frame_milliseconds{};
+        double gpu_milliseconds{};
+        double triangles{};
+        // Summed over the measured frames, only counted in builds that track allocations.
+        std::array<AllocationTracker::Counter, AllocationTracker::PHASE_COUNT> allocations{};
+    };
+
+  private:
+    // Index into INSTANCE_COUNTS, -1 while not running.
+    int m_run{-1};
+    int m_frame{};
+    int m_max_instances{};
+    Result m_sum;
+    std::vector<Result> m_results;
+    bool m_finished{false};
+
+  public:
+    explicit ScalingBenchmark() = default;
+    ScalingBenchmark(const ScalingBenchmark &) = delete;
+    const ScalingBenchmark &operator=(const ScalingBenchmark &) = delete;
+
+    void start(int max_instances);
+    [[nodiscard]] bool is_running() const;
+    // Whether a benchmark has run to the end since the last `start`.
+    [[nodiscard]] bool is_finished() const;
+    // The number of instances to draw in the current run.
+    [[nodiscard]] int get_instance_count() const;
+    // Records the measurements of a frame and advances to the next run when enough were taken.
+    // Call after AllocationTracker::end_frame.
+    void record(double frame_milliseconds, double gpu_milliseconds, std::uint64_t triangles);
+
+    // The results of the finished runs, in the order of INSTANCE_COUNTS.
+    [[nodiscard]] const std::vector<Result> &get_results() const;
+};
+
+#endif // SCALING_BENCHMARK_H
@@ -0,0 +1,681 @@
+#include "SceneGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include <glm/gtc/quaternion.hpp>
+#include <spdlog/spdlog.h>
+
+#include "GLState.h"
+
+namespace
+{
+std::int16_t to_snorm16(const float value)
+{
+    return static_cast<std::int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+// Encodes the tangent frame as a quaternion rotating (x, y, z) to (tangent, bitangent, normal).
+// The bitangent is cross(normal, tangent), like in the unpacked path, so the frame is never
+// mirrored and w can be kept positive.
+glm::quat encode_tangent_frame(const glm::vec3 &normal, const glm::vec3 &tangent)
+{
+    const auto n = glm::normalize(normal);
+    auto t = tangent - n * glm::dot(n, tangent);
+    if (glm::dot(t, t) < 1e-12f)
+    {
+        // Meshes without texture coordinates have no tangents.
+        t = std::abs(n.x) < 0.9f ? glm::cross(n, glm::vec3(1.0f, 0.0f, 0.0f))
+                                 : glm::cross(n, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    t = glm::normalize(t);
+
+    auto q = glm::normalize(glm::quat_cast(glm::mat3(t, glm::cross(n, t), n)));
+    if (q.w < 0.0f)
+    {
+        q = -q;
+    }
+    return q;
+}
+} // namespace
+
+GLuint SceneGeometry::add_mesh(
+    const MeshGeometry &mesh, const GLuint material, const glm::mat4 &model
+)
+{
+    if (m_vao)
+    {
+        throw std::runtime_error("scene geometry has already been uploaded");
+    }
+
+    auto min = glm::vec3(std::numeric_limits<float>::max());
+    auto max = glm::vec3(std::numeric_limits<float>::lowest());
+    for (const auto &vertex : mesh.vertices)
+    {
+        min = glm::min(min, vertex.position);
+        max = glm::max(max, vertex.position);
+    }
+    const auto center = (min + max) * 0.5f;
+    auto radius = 0.0f;
+    for (const auto &vertex : mesh.vertices)
+    {
+        radius = std::max(radius, glm::distance(center, vertex.position));
+    }
+
+    const auto draw = static_cast<GLuint>(m_draws.size());
+    const auto first_index = static_cast<GLuint>(m_indices.size());
+    DrawData data{
+        .model = model,
+        .bounds = glm::vec4(center, radius),
+        .material = material,
+        .base_vertex = static_cast<GLint>(m_vertices.size()),
+        .lod_count = 1,
+        .mesh = static_cast<GLuint>(m_meshes.size()),
+        .lods = {Lod{
+            .first_index = first_index,
+            .index_count = static_cast<GLuint>(mesh.indices.size()),
+        }},
+    };
+    if (mesh.lods.size() > MAX_LODS)
+    {
+        throw std::runtime_error(fmt::format("mesh has more than {} levels of detail", MAX_LODS));
+    }
+    if (!mesh.lods.empty())
+    {
+        data.lod_count = static_cast<GLuint>(mesh.lods.size());
+        for (std::size_t i = 0; i < mesh.lods.size(); ++i)
+        {
+            data.lods[i] = Lod{
+                .first_index = first_index + mesh.lods[i].first_index,
+                .index_count = mesh.lods[i].index_count,
+                .error = mesh.lods[i].error,
+            };
+        }
+    }
+    m_draws.push_back(data);
+
+    const auto first_meshlet = static_cast<GLuint>(m_meshlets.size());
+    if (mesh.meshlets.empty())
+    {
+        for (GLuint lod = 0; lod < data.lod_count; ++lod)
+        {
+            m_meshlets.push_back(MeshletData{
+                .bounds = data.bounds,
+                .cone = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+                .index_count = data.lods[lod].index_count,
+                .first_index = data.lods[lod].first_index,
+                .lod = lod,
+            });
+        }
+    }
+    for (const auto &meshlet : mesh.meshlets)
+    {
+        m_meshlets.push_back(MeshletData{
+            .bounds = meshlet.bounds,
+            .cone = meshlet.cone,
+            .index_count = meshlet.index_count,
+            .first_index = first_index + meshlet.first_index,
+            .lod = meshlet.lod,
+        });
+    }
+
+    // MeshOptimizer emits the meshlets of every level of detail after those of the previous one.
+    MeshData mesh_data{};
+    GLuint max_meshlet_count = 0;
+    for (auto i = first_meshlet; i < m_meshlets.size(); ++i)
+    {
+        const auto lod = m_meshlets[i].lod;
+        if (lod >= data.lod_count || (i > first_meshlet && lod < m_meshlets[i - 1].lod))
+        {
+            throw std::runtime_error("meshlets are not sorted by level of detail");
+        }
+        if (mesh_data.meshlet_counts[lod]++ == 0)
+        {
+            mesh_data.first_meshlets[lod] = i;
+        }
+        max_meshlet_count = std::max(max_meshlet_count, mesh_data.meshlet_counts[lod]);
+    }
+    m_mesh_data.push_back(mesh_data);
+    m_meshes.push_back(MeshRange{
+        .draw = draw,
+        .vertex_count = static_cast<GLuint>(mesh.vertices.size()),
+        .max_meshlet_count = max_meshlet_count,
+    });
+
+    m_vertices.insert(m_vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+    m_indices.insert(m_indices.end(), mesh.indices.begin(), mesh.indices.end());
+    m_max_mesh_vertices =
+        std::max(m_max_mesh_vertices, static_cast<GLuint>(mesh.vertices.size()));
+
+    return draw;
+}
+
+GLuint SceneGeometry::add_instance(const GLuint draw, const GLuint material, const glm::mat4 &model)
+{
+    if (m_vao)
+    {
+        throw std::runtime_error("scene geometry has already been uploaded");
+    }
+
+    const auto instance = static_cast<GLuint>(m_draws.size());
+    auto data = m_draws[draw];
+    data.model = model;
+    data.material = material;
+    m_draws.push_back(data);
+    return instance;
+}
+
+void SceneGeometry::upload(const std::size_t material_count, const VertexFormat vertex_format)
+{
+    m_vertex_format = vertex_format;
+    m_batch_offsets.assign(material_count, 0);
+    m_batch_sizes.assign(material_count, 0);
+    m_meshlet_batch_offsets.assign(material_count, 0);
+    m_meshlet_batch_sizes.assign(material_count, 0);
+    m_active_draw_count = static_cast<GLuint>(m_draws.size());
+    build_draw_order();
+    m_draw_dirty.assign(m_draws.size(), false);
+
+    upload_vertices();
+    if (m_max_mesh_vertices <= 65536)
+    {
+        const std::vector<std::uint16_t> indices(m_indices.begin(), m_indices.end());
+        m_index_buffer.emplace(
+            static_cast<GLsizeiptr>(indices.size() * sizeof(std::uint16_t)),
+            indices.data(),
+            0
+        );
+        m_index_type = GL_UNSIGNED_SHORT;
+    }
+    else
+    {
+        m_index_buffer.emplace(
+            static_cast<GLsizeiptr>(m_indices.size() * sizeof(std::uint32_t)),
+            m_indices.data(),
+            0
+        );
+        m_index_type = GL_UNSIGNED_INT;
+    }
+    m_draw_buffer.emplace(
+        static_cast<GLsizeiptr>(m_draws.size() * sizeof(DrawData)),
+        m_draws.data(),
+        GL_DYNAMIC_STORAGE_BIT
+    );
+    m_draw_order_buffer.emplace(
+        static_cast<GLsizeiptr>(m_draw_order.size() * sizeof(GLuint)),
+        m_draw_order.data(),
+        GL_DYNAMIC_STORAGE_BIT
+    );
+    m_batch_offset_buffer.emplace(
+        static_cast<GLsizeiptr>(m_batch_offsets.size() * sizeof(GLuint)),
+        m_batch_offsets.data(),
+        GL_DYNAMIC_STORAGE_BIT
+    );
+    m_meshlet_buffer.emplace(
+        static_cast<GLsizeiptr>(m_meshlets.size() * sizeof(MeshletData)),
+        m_meshlets.data(),
+        0
+    );
+    m_mesh_buffer.emplace(
+        static_cast<GLsizeiptr>(m_mesh_data.size() * sizeof(MeshData)),
+        m_mesh_data.data(),
+        0
+    );
+    m_meshlet_offset_buffer.emplace(
+        static_cast<GLsizeiptr>(m_meshlet_offsets.size() * sizeof(GLuint)),
+        m_meshlet_offsets.data(),
+        GL_DYNAMIC_STORAGE_BIT
+    );
+    m_meshlet_batch_offset_buffer.emplace(
+        static_cast<GLsizeiptr>(m_meshlet_batch_offsets.size() * sizeof(GLuint)),
+        m_meshlet_batch_offsets.data(),
+        GL_DYNAMIC_STORAGE_BIT
+    );
+
+    m_memory_stats = MemoryStats{
+        .vertex_bytes = m_vertex_buffer->get_size(),
+        .position_bytes = m_position_buffer->get_size(),
+        .index_bytes = m_index_buffer->get_size(),
+        .unpacked_bytes = static_cast<GLsizeiptr>(
+            m_vertices.size() * (sizeof(Mesh::Vertex) + sizeof(glm::vec3)) +
+            m_indices.size() * sizeof(std::uint32_t)
+        ),
+    };
+    const auto total = m_memory_stats.vertex_bytes + m_memory_stats.position_bytes +
+                       m_memory_stats.index_bytes;
+    spdlog::info(
+        "scene geometry: {:.2f} MiB ({:.2f} MiB vertices, {:.2f} MiB positions, {:.2f} MiB "
+        "{}-bit indices), {:.0f}% of the unpacked size",
+        static_cast<double>(total) / (1024.0 * 1024.0),
+        static_cast<double>(m_memory_stats.vertex_bytes) / (1024.0 * 1024.0),
+        static_cast<double>(m_memory_stats.position_bytes) / (1024.0 * 1024.0),
+        static_cast<double>(m_memory_stats.index_bytes) / (1024.0 * 1024.0),
+        m_index_type == GL_UNSIGNED_SHORT ? 16 : 32,
+        100.0 * static_cast<double>(total) / static_cast<double>(m_memory_stats.unpacked_bytes)
+    );
+
+    m_vertices = {};
+    m_indices = {};
+
+    const auto attribute = [](const GLuint vao,
+                              const GLuint index,
+                              const GLint size,
+                              const GLenum type,
+                              const GLuint offset) {
+        glEnableVertexArrayAttrib(vao, index);
+        glVertexArrayAttribFormat(vao, index, size, type, type == GL_SHORT, offset);
+        glVertexArrayAttribBinding(vao, index, 0);
+    };
+
+    // The same indices and base vertices address the position stream.
+    m_vao = VertexArrayObject::create();
+    m_position_vao = VertexArrayObject::create();
+    const auto vao = m_vao.get();
+    const auto position_vao = m_position_vao.get();
+    glVertexArrayElementBuffer(vao, m_index_buffer->get_handle());
+    glVertexArrayElementBuffer(position_vao, m_index_buffer->get_handle());
+
+    if (m_vertex_format == VertexFormat::Full)
+    {
+        glVertexArrayVertexBuffer(vao, 0, m_vertex_buffer->get_handle(), 0, sizeof(Mesh::Vertex));
+        attribute(vao, 0, 3, GL_FLOAT, offsetof(Mesh::Vertex, position));
+        attribute(vao, 1, 3, GL_FLOAT, offsetof(Mesh::Vertex, normal));
+        attribute(vao, 2, 2, GL_FLOAT, offsetof(Mesh::Vertex, tex_coords));
+        attribute(vao, 3, 3, GL_FLOAT, offsetof(Mesh::Vertex, tangent));
+
+        glVertexArrayVertexBuffer(
+            position_vao,
+            0,
+            m_position_buffer->get_handle(),
+            0,
+            sizeof(glm::vec3)
+        );
+        attribute(position_vao, 0, 3, GL_FLOAT, 0);
+    }
+    else
+    {
+        glVertexArrayVertexBuffer(vao, 0, m_vertex_buffer->get_handle(), 0, sizeof(PackedVertex));
+        attribute(vao, 0, 3, GL_SHORT, offsetof(PackedVertex, position));
+        attribute(vao, 2, 2, GL_HALF_FLOAT, offsetof(PackedVertex, tex_coords));
+        attribute(vao, 3, 4, GL_SHORT, offsetof(PackedVertex, tangent_frame));
+
+        glVertexArrayVertexBuffer(
+            position_vao,
+            0,
+            m_position_buffer->get_handle(),
+            0,
+            sizeof(PackedVertex::position)
+        );
+        attribute(position_vao, 0, 3, GL_SHORT, 0);
+    }
+}
+
+void SceneGeometry::upload_vertices()
+{
+    if (m_vertex_format == VertexFormat::Full)
+    {
+        std::vector<glm::vec3> positions;
+        positions.reserve(m_vertices.size());
+        for (const auto &vertex : m_vertices)
+        {
+            positions.push_back(vertex.position);
+        }
+        m_vertex_buffer.emplace(
+            static_cast<GLsizeiptr>(m_vertices.size() * sizeof(Mesh::Vertex)),
+            m_vertices.data(),
+            0
+        );
+        m_position_buffer.emplace(
+            static_cast<GLsizeiptr>(positions.size() * sizeof(glm::vec3)),
+            positions.data(),
+            0
+        );
+        return;
+    }
+
+    std::vector<PackedVertex> vertices(m_vertices.size());
+    std::vector<std::array<std::int16_t, 4>> positions(m_vertices.size());
+    for (const auto &mesh : m_meshes)
+    {
+        const auto &draw = m_draws[mesh.draw];
+        const auto first = static_cast<std::size_t>(draw.base_vertex);
+        const auto last = first + mesh.vertex_count;
+        const auto center = glm::vec3(draw.bounds);
+        const auto radius = std::max(draw.bounds.w, std::numeric_limits<float>::min());
+
+        for (auto j = first; j < last; ++j)
+        {
+            const auto &vertex = m_vertices[j];
+            const auto position = (vertex.position - center) / radius;
+            const auto tangent_frame = encode_tangent_frame(vertex.normal, vertex.tangent);
+            vertices[j] = PackedVertex{
+                .position =
+                    {
+                        to_snorm16(position.x),
+                        to_snorm16(position.y),
+                        to_snorm16(position.z),
+                    },
+                .tex_coords = glm::packHalf2x16(vertex.tex_coords),
+                .tangent_frame =
+                    {
+                        to_snorm16(tangent_frame.x),
+                        to_snorm16(tangent_frame.y),
+                        to_snorm16(tangent_frame.z),
+                        to_snorm16(tangent_frame.w),
+                    },
+            };
+            positions[j] = vertices[j].position;
+        }
+    }
+
+    m_vertex_buffer.emplace(
+        static_cast<GLsizeiptr>(vertices.size() * sizeof(PackedVertex)),
+        vertices.data(),
+        0
+    );
+    m_position_buffer.emplace(
+        static_cast<GLsizeiptr>(positions.size() * sizeof(positions[0])),
+        positions.data(),
+        0
+    );
+}
+
+void SceneGeometry::set_model_matrix(const GLuint draw, const glm::mat4 &model)
+{
+    m_draws[draw].model = model;
+    mark_dirty(draw);
+}
+
+void SceneGeometry::set_material(const GLuint draw, const GLuint material)
+{
+    if (m_draws[draw].material == material)
+    {
+        return;
+    }
+    m_draws[draw].material = material;
+    mark_dirty(draw);
+    m_order_dirty = true;
+}
+
+void SceneGeometry::set_active_draw_count(const GLuint count)
+{
+    const auto active = std::min(count, static_cast<GLuint>(m_draws.size()));
+    if (active != m_active_draw_count)
+    {
+        m_active_draw_count = active;
+        update_batch_sizes();
+        ++m_version;
+    }
+}
+
+GLuint SceneGeometry::flush(RingBuffer &ring)
+{
+    if (m_order_dirty)
+    {
+        build_draw_order();
+        ring.stage(
+            *m_draw_order_buffer,
+            0,
+            static_cast<GLsizeiptr>(m_draw_order.size() * sizeof(GLuint)),
+            m_draw_order.data()
+        );
+        ring.stage(
+            *m_batch_offset_buffer,
+            0,
+            static_cast<GLsizeiptr>(m_batch_offsets.size() * sizeof(GLuint)),
+            m_batch_offsets.data()
+        );
+        ring.stage(
+            *m_meshlet_offset_buffer,
+            0,
+            static_cast<GLsizeiptr>(m_meshlet_offsets.size() * sizeof(GLuint)),
+            m_meshlet_offsets.data()
+        );
+        ring.stage(
+            *m_meshlet_batch_offset_buffer,
+            0,
+            static_cast<GLsizeiptr>(m_meshlet_batch_offsets.size() * sizeof(GLuint)),
+            m_meshlet_batch_offsets.data()
+        );
+        m_order_dirty = false;
+        ++m_version;
+    }
+
+    const auto uploaded = static_cast<GLuint>(m_dirty_draws.size());
+    if (m_dirty_draws.size() > m_draws.size() / 4)
+    {
+        ring.stage(
+            *m_draw_buffer,
+            0,
+            static_cast<GLsizeiptr>(m_draws.size() * sizeof(DrawData)),
+            m_draws.data()
+        );
+    }
+    else
+    {
+        // Upload contiguous runs of dirty draws with one call each.
+        std::ranges::sort(m_dirty_draws);
+        for (std::size_t i = 0; i < m_dirty_draws.size();)
+        {
+            auto j = i + 1;
+            while (j < m_dirty_draws.size() && m_dirty_draws[j] == m_dirty_draws[j - 1] + 1)
+            {
+                ++j;
+            }
+            ring.stage(
+                *m_draw_buffer,
+                static_cast<GLintptr>(m_dirty_draws[i] * sizeof(DrawData)),
+                static_cast<GLsizeiptr>((j - i) * sizeof(DrawData)),
+                &m_draws[m_dirty_draws[i]]
+            );
+            i = j;
+        }
+    }
+
+    for (const auto draw : m_dirty_draws)
+    {
+        m_draw_dirty[draw] = false;
+    }
+    m_dirty_draws.clear();
+
+    return uploaded;
+}
+
+std::uint64_t SceneGeometry::get_version() const
+{
+    return m_version;
+}
+
+SceneGeometry::VertexFormat SceneGeometry::get_vertex_format() const
+{
+    return m_vertex_format;
+}
+
+GLenum SceneGeometry::get_index_type() const
+{
+    return m_index_type;
+}
+
+const SceneGeometry::MemoryStats &SceneGeometry::get_memory_stats() const
+{
+    return m_memory_stats;
+}
+
+void SceneGeometry::bind(const VertexStream stream) const
+{
+    GLState::get().bind_vertex_array(
+        stream == VertexStream::Full ? m_vao.get() : m_position_vao.get()
+    );
+    m_draw_buffer->bind_base(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING);
+    m_draw_order_buffer->bind_base(GL_SHADER_STORAGE_BUFFER, DRAW_ORDER_BINDING);
+    m_batch_offset_buffer->bind_base(GL_SHADER_STORAGE_BUFFER, BATCH_OFFSET_BINDING);
+}
+
+void SceneGeometry::bind(CommandList &commands, const VertexStream stream) const
+{
+    commands.bind_vertex_array(stream == VertexStream::Full ? m_vao.get() : m_position_vao.get());
+    commands.bind_buffer_base(
+        GL_SHADER_STORAGE_BUFFER,
+        DRAW_DATA_BINDING,
+        m_draw_buffer->get_handle()
+    );
+    commands.bind_buffer_base(
+        GL_SHADER_STORAGE_BUFFER,
+        DRAW_ORDER_BINDING,
+        m_draw_order_buffer->get_handle()
+    );
+    commands.bind_buffer_base(
+        GL_SHADER_STORAGE_BUFFER,
+        BATCH_OFFSET_BINDING,
+        m_batch_offset_buffer->get_handle()
+    );
+}
+
+void SceneGeometry::bind_meshlets() const
+{
+    m_meshlet_buffer->bind_base(GL_SHADER_STORAGE_BUFFER, MESHLET_BINDING);
+    m_mesh_buffer->bind_base(GL_SHADER_STORAGE_BUFFER, MESH_BINDING);
+    m_meshlet_offset_buffer->bind_base(GL_SHADER_STORAGE_BUFFER, MESHLET_OFFSET_BINDING);
+    m_meshlet_batch_offset_buffer->bind_base(GL_SHADER_STORAGE_BUFFER, BATCH_OFFSET_BINDING);
+}
+
+GLuint SceneGeometry::get_draw_count() const
+{
+    return static_cast<GLuint>(m_draws.size());
+}
+
+GLuint SceneGeometry::get_mesh_count() const
+{
+    return static_cast<GLuint>(m_meshes.size());
+}
+
+GLuint SceneGeometry::get_active_draw_count() const
+{
+    return m_active_draw_count;
+}
+
+std::span<const SceneGeometry::DrawData> SceneGeometry::get_draws() const
+{
+    return m_draws;
+}
+
+std::span<const GLuint> SceneGeometry::get_batch_offsets() const
+{
+    return m_batch_offsets;
+}
+
+std::span<const GLuint> SceneGeometry::get_batch_sizes() const
+{
+    return m_batch_sizes;
+}
+
+GLuint SceneGeometry::get_meshlet_count() const
+{
+    return static_cast<GLuint>(m_meshlets.size());
+}
+
+GLuint SceneGeometry::get_meshlet_command_count() const
+{
+    return m_meshlet_offsets.back();
+}
+
+std::span<const GLuint> SceneGeometry::get_meshlet_batch_offsets() const
+{
+    return m_meshlet_batch_offsets;
+}
+
+std::span<const GLuint> SceneGeometry::get_meshlet_batch_sizes() const
+{
+    return m_meshlet_batch_sizes;
+}
+
+GLuint SceneGeometry::select_lod(
+    const GLuint draw, const glm::vec4 &viewer, const float lod_scale
+) const
+{
+    const auto &data = m_draws[draw];
+    if (lod_scale == 0.0f)
+    {
+        return 0;
+    }
+
+    const auto model = glm::mat3(data.model);
+    const auto scale =
+        std::max({glm::length(model[0]), glm::length(model[1]), glm::length(model[2])});
+    auto distance = 1.0f;
+    if (viewer.w != 0.0f)
+    {
+        const auto center = glm::vec3(data.model * glm::vec4(glm::vec3(data.bounds), 1.0f));
+        distance = glm::distance(center, glm::vec3(viewer)) - data.bounds.w * scale;
+        if (distance <= 0.0f)
+        {
+            return 0;
+        }
+    }
+
+    GLuint lod = 0;
+    while (lod + 1 < data.lod_count && data.lods[lod + 1].error * scale * lod_scale <= distance)
+    {
+        ++lod;
+    }
+    return lod;
+}
+
+void SceneGeometry::mark_dirty(const GLuint draw)
+{
+    if (!m_draw_dirty[draw])
+    {
+        m_draw_dirty[draw] = true;
+        m_dirty_draws.push_back(draw);
+    }
+}
+
+void SceneGeometry::build_draw_order()
+{
+    m_draw_order.resize(m_draws.size());
+    std::iota(m_draw_order.begin(), m_draw_order.end(), 0);
+    // Draws of the same material stay sorted by index, so the active ones come first.
+    std::ranges::stable_sort(m_draw_order, {}, [this](const GLuint draw) {
+        return m_draws[draw].material;
+    });
+
+    std::ranges::fill(m_batch_sizes, 0);
+    for (const auto &draw : m_draws)
+    {
+        ++m_batch_sizes[draw.material];
+    }
+    for (std::size_t i = 1; i < m_batch_sizes.size(); ++i)
+    {
+        m_batch_offsets[i] = m_batch_offsets[i - 1] + m_batch_sizes[i - 1];
+    }
+
+    m_meshlet_offsets.resize(m_draw_order.size() + 1);
+    m_meshlet_offsets[0] = 0;
+    for (std::size_t i = 0; i < m_draw_order.size(); ++i)
+    {
+        const auto &mesh = m_meshes[m_draws[m_draw_order[i]].mesh];
+        m_meshlet_offsets[i + 1] = m_meshlet_offsets[i] + mesh.max_meshlet_count;
+    }
+    for (std::size_t i = 0; i < m_meshlet_batch_offsets.size(); ++i)
+    {
+        m_meshlet_batch_offsets[i] = m_meshlet_offsets[m_batch_offsets[i]];
+    }
+    update_batch_sizes();
+}
+
+void SceneGeometry::update_batch_sizes()
+{
+    std::ranges::fill(m_batch_sizes, 0);
+    for (GLuint draw = 0; draw < m_active_draw_count; ++draw)
+    {
+        ++m_batch_sizes[m_draws[draw].material];
+    }
+    for (std::size_t i = 0; i < m_meshlet_batch_sizes.size(); ++i)
+    {
+        m_meshlet_batch_sizes[i] =
+            m_meshlet_offsets[m_batch_offsets[i] + m_batch_sizes[i]] - m_meshlet_batch_offsets[i];
+    }
+}
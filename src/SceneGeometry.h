@@ -0,0 +1,244 @@
+#ifndef SCENE_GEOMETRY_H
+#define SCENE_GEOMETRY_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Buffer.h"
+#include "CommandList.h"
+#include "GLObject.h"
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "RingBuffer.h"
+
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+};
+
+// All static scene geometry, suballocated from one vertex and one index buffer. Positions are also
+// kept in a separate tightly packed buffer for depth-only passes. `get_batch_offsets` and
+// `get_batch_sizes` describe the range of every material in the material-sorted draw order, and
+// `get_meshlet_batch_offsets` and `get_meshlet_batch_sizes` the same for the meshlet commands of
+// the draws in that order, where every draw has room for the meshlets of its level of detail with
+// the most. Meshlets are stored once per mesh and shared by all instances of it. The batch
+// sizes only count the active draws, which come first in every batch.
+class SceneGeometry
+{
+  public:
+    static constexpr std::size_t MAX_LODS = MeshOptimizer::MAX_LODS;
+
+    // Mirrors `Lod` in the shaders (std430).
+    struct Lod
+    {
+        GLuint first_index;
+        GLuint index_count;
+        // In model units, see MeshLod.
+        float error;
+        GLuint padding;
+    };
+
+    // Mirrors `DrawData` in the shaders (std430).
+    struct DrawData
+    {
+        glm::mat4 model;
+        // xyz = bounding sphere center in model space, w = radius.
+        glm::vec4 bounds;
+        GLuint material;
+        GLint base_vertex;
+        GLuint lod_count;
+        // The geometry, shared by all instances of it.
+        GLuint mesh;
+        // Finest first.
+        std::array<Lod, MAX_LODS> lods;
+    };
+    static_assert(sizeof(DrawData) == 160);
+
+    // Mirrors `MeshletData` in the shaders (std430).
+    struct MeshletData
+    {
+        // In model space, see Meshlet.
+        glm::vec4 bounds;
+        glm::vec4 cone;
+        GLuint index_count;
+        GLuint first_index;
+        GLuint lod;
+        GLuint padding;
+    };
+    static_assert(sizeof(MeshletData) == 48);
+
+    // Mirrors `MeshData` in the shaders (std430). The meshlets of every level of detail.
+    struct MeshData
+    {
+        std::array<GLuint, MAX_LODS> first_meshlets;
+        std::array<GLuint, MAX_LODS> meshlet_counts;
+    };
+    static_assert(sizeof(MeshData) == 32);
+
+    static constexpr GLuint DRAW_DATA_BINDING = 0;
+    static constexpr GLuint DRAW_ID_BINDING = 2;
+    static constexpr GLuint BATCH_OFFSET_BINDING = 4;
+    static constexpr GLuint DRAW_ORDER_BINDING = 5;
+    static constexpr GLuint MESHLET_BINDING = 6;
+    static constexpr GLuint MESH_BINDING = 8;
+    static constexpr GLuint MESHLET_OFFSET_BINDING = 9;
+
+    enum class VertexFormat
+    {
+        // Mesh::Vertex, 44 bytes.
+        Full,
+        // PackedVertex, 20 bytes. Shaders have to decode it, see shaders/packed_vertex.glsl.
+        Packed,
+    };
+
+    // Positions are snorm16 relative to the bounding sphere of their draw, texture coordinates
+    // are half floats and the normal and tangent are encoded as a quaternion (QTangent).
+    struct PackedVertex
+    {
+        std::array<std::int16_t, 4> position;
+        std::uint32_t tex_coords;
+        std::array<std::int16_t, 4> tangent_frame;
+    };
+    static_assert(sizeof(PackedVertex) == 20);
+
+    struct MemoryStats
+    {
+        GLsizeiptr vertex_bytes{};
+        GLsizeiptr position_bytes{};
+        GLsizeiptr index_bytes{};
+        // The size of the same geometry as Mesh::Vertex and 32-bit indices.
+        GLsizeiptr unpacked_bytes{};
+    };
+
+    enum class VertexStream
+    {
+        // All attributes of Mesh::Vertex.
+        Full,
+        // Only the position at attribute 0, for depth-only passes.
+        PositionOnly,
+    };
+
+  private:
+    // The vertices of a mesh added with `add_mesh`.
+    struct MeshRange
+    {
+        GLuint draw;
+        GLuint vertex_count;
+        // The meshlet count of the level of detail with the most.
+        GLuint max_meshlet_count;
+    };
+
+    std::vector<Mesh::Vertex> m_vertices;
+    std::vector<std::uint32_t> m_indices;
+    GLuint m_max_mesh_vertices{};
+    VertexFormat m_vertex_format{VertexFormat::Full};
+    GLenum m_index_type{GL_UNSIGNED_INT};
+    MemoryStats m_memory_stats;
+    std::vector<MeshRange> m_meshes;
+    std::vector<MeshData> m_mesh_data;
+    std::vector<DrawData> m_draws;
+    std::vector<GLuint> m_draw_order;
+    std::vector<GLuint> m_batch_offsets;
+    std::vector<GLuint> m_batch_sizes;
+    std::vector<MeshletData> m_meshlets;
+    // The first meshlet command of every draw in the draw order, followed by the total.
+    std::vector<GLuint> m_meshlet_offsets;
+    std::vector<GLuint> m_meshlet_batch_offsets;
+    std::vector<GLuint> m_meshlet_batch_sizes;
+    GLuint m_active_draw_count{};
+
+    std::vector<bool> m_draw_dirty;
+    std::vector<GLuint> m_dirty_draws;
+    bool m_order_dirty{false};
+    std::uint64_t m_version{};
+
+    VertexArrayObject m_vao;
+    VertexArrayObject m_position_vao;
+    std::optional<Buffer> m_vertex_buffer;
+    std::optional<Buffer> m_position_buffer;
+    std::optional<Buffer> m_index_buffer;
+    std::optional<Buffer> m_draw_buffer;
+    std::optional<Buffer> m_draw_order_buffer;
+    std::optional<Buffer> m_batch_offset_buffer;
+    std::optional<Buffer> m_meshlet_buffer;
+    std::optional<Buffer> m_mesh_buffer;
+    std::optional<Buffer> m_meshlet_offset_buffer;
+    std::optional<Buffer> m_meshlet_batch_offset_buffer;
+
+  public:
+    explicit SceneGeometry() = default;
+    SceneGeometry(const SceneGeometry &) = delete;
+    const SceneGeometry &operator=(const SceneGeometry &) = delete;
+
+    // Returns the index of the draw, which stays valid after `upload`. Without levels of detail
+    // all indices are the only level, and without meshlets every level is culled as one.
+    GLuint add_mesh(const MeshGeometry &mesh, GLuint material, const glm::mat4 &model);
+    // Adds a draw of the same geometry as `draw`, with its own transform and material. Draws of
+    // the same mesh and level of detail can be submitted as instances of one indirect command.
+    GLuint add_instance(GLuint draw, GLuint material, const glm::mat4 &model);
+
+    // Indices are stored as 16-bit if no mesh has more than 65536 vertices, since they are
+    // relative to the base vertex of their draw.
+    void upload(std::size_t material_count, VertexFormat vertex_format = VertexFormat::Full);
+
+    // Changes to the draws are kept on the CPU until `flush` stages them through the ring and
+    // copies them in place on the GPU. Changing a
+    // material also changes the draw order and bumps the version returned by `get_version`, so
+    // that retained draw lists know they need to be recorded again.
+    void set_model_matrix(GLuint draw, const glm::mat4 &model);
+    void set_material(GLuint draw, GLuint material);
+    // Leaves all but the first `count` draws out of the batches, so that the GPU-driven path does
+    // not draw them, e.g. to benchmark a growing part of the scene. The draw order stays the same,
+    // so only the batch sizes change and nothing has to be uploaded.
+    void set_active_draw_count(GLuint count);
+    // Returns the number of draws that were uploaded.
+    GLuint flush(RingBuffer &ring);
+    [[nodiscard]] std::uint64_t get_version() const;
+
+    void bind(VertexStream stream = VertexStream::Full) const;
+    // Records the same binds into `commands`.
+    void bind(CommandList &commands, VertexStream stream = VertexStream::Full) const;
+    // Binds the meshlets and their offsets, and their batch offsets in place of those of the
+    // draws.
+    void bind_meshlets() const;
+
+    [[nodiscard]] VertexFormat get_vertex_format() const;
+    [[nodiscard]] GLenum get_index_type() const;
+    [[nodiscard]] const MemoryStats &get_memory_stats() const;
+    [[nodiscard]] GLuint get_draw_count() const;
+    [[nodiscard]] GLuint get_active_draw_count() const;
+    [[nodiscard]] GLuint get_mesh_count() const;
+    [[nodiscard]] std::span<const DrawData> get_draws() const;
+    [[nodiscard]] std::span<const GLuint> get_batch_offsets() const;
+    [[nodiscard]] std::span<const GLuint> get_batch_sizes() const;
+    // The number of meshlets of all meshes and levels of detail.
+    [[nodiscard]] GLuint get_meshlet_count() const;
+    // The number of commands meshlet culling needs, see `get_meshlet_batch_offsets`.
+    [[nodiscard]] GLuint get_meshlet_command_count() const;
+    [[nodiscard]] std::span<const GLuint> get_meshlet_batch_offsets() const;
+    [[nodiscard]] std::span<const GLuint> get_meshlet_batch_sizes() const;
+
+    // Selects the coarsest level of detail of the draw whose error stays below the threshold on
+    // screen, like the cull shader. The LOD scale is the projected size of one model unit at a
+    // distance of 1, in multiples of the threshold, and 0 to always select the finest level.
+    // The viewer is the camera position with w = 1, or the view direction with w = 0.
+    [[nodiscard]] GLuint select_lod(GLuint draw, const glm::vec4 &viewer, float lod_scale) const;
+
+  private:
+    void upload_vertices();
+    void mark_dirty(GLuint draw);
+    void build_draw_order();
+    void update_batch_sizes();
+};
+
+#endif // SCENE_GEOMETRY_H
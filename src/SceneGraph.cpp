@@ -0,0 +1,159 @@
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define SCENE_GRAPH_SSE
+#endif
+
+namespace
+{
+// result = parent * local for every node in the batch, in order, so that a node's parent is
+// always computed before the node itself.
+void multiply_world_matrices(
+    std::span<const std::uint32_t> nodes, const std::uint32_t *parents, const glm::mat4 *local,
+    glm::mat4 *world
+)
+{
+    for (const auto node : nodes)
+    {
+        const auto parent = parents[node];
+        if (parent == SceneGraph::NO_PARENT)
+        {
+            world[node] = local[node];
+            continue;
+        }
+
+#ifdef SCENE_GRAPH_SSE
+        // Every column of the result is a linear combination of the parent's columns.
+        const auto *a = &world[parent][0][0];
+        const auto a0 = _mm_loadu_ps(a);
+        const auto a1 = _mm_loadu_ps(a + 4);
+        const auto a2 = _mm_loadu_ps(a + 8);
+        const auto a3 = _mm_loadu_ps(a + 12);
+        const auto *b = &local[node][0][0];
+        auto *result = &world[node][0][0];
+        for (auto column = 0; column < 4; ++column)
+        {
+            const auto *b_column = b + 4 * column;
+            auto sum = _mm_mul_ps(a0, _mm_set1_ps(b_column[0]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_set1_ps(b_column[1])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_set1_ps(b_column[2])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a3, _mm_set1_ps(b_column[3])));
+            _mm_storeu_ps(result + 4 * column, sum);
+        }
+#else
+        world[node] = world[parent] * local[node];
+#endif
+    }
+}
+} // namespace
+
+std::uint32_t SceneGraph::add_node(const std::uint32_t parent, const glm::mat4 &local)
+{
+    const auto node = get_node_count();
+    if (parent != NO_PARENT && parent >= node)
+    {
+        throw std::runtime_error(
+            fmt::format("scene graph node {} added before its parent {}", node, parent)
+        );
+    }
+
+    if (parent == NO_PARENT)
+    {
+        m_last_root = node;
+    }
+    else if (parent < m_last_root)
+    {
+        m_trees_contiguous = false;
+    }
+
+    m_parents.push_back(parent);
+    m_local.push_back(local);
+    m_world.push_back(parent == NO_PARENT ? local : m_world[parent] * local);
+    m_dirty.push_back(0);
+    if (m_first_dirty == node)
+    {
+        m_first_dirty = node + 1;
+    }
+    return node;
+}
+
+void SceneGraph::set_local(const std::uint32_t node, const glm::mat4 &local)
+{
+    m_local[node] = local;
+    m_dirty[node] = 1;
+    m_first_dirty = std::min(m_first_dirty, node);
+}
+
+std::span<const std::uint32_t> SceneGraph::update(JobSystem &jobs)
+{
+    m_updated.clear();
+    const auto node_count = get_node_count();
+    if (m_first_dirty == node_count)
+    {
+        return m_updated;
+    }
+
+    // Parents come first, so one pass carries the dirty flags down to all descendants.
+    for (auto node = m_first_dirty; node < node_count; ++node)
+    {
+        const auto parent = m_parents[node];
+        if (m_dirty[node] || (parent != NO_PARENT && m_dirty[parent]))
+        {
+            m_dirty[node] = 1;
+            m_updated.push_back(node);
+        }
+    }
+
+    // A node's parent is either not updated or in the same tree, so the updated nodes can be
+    // split between jobs at the roots.
+    m_update_splits.assign(1, 0);
+    const auto updated_count = static_cast<std::uint32_t>(m_updated.size());
+    for (std::uint32_t i = UPDATE_GRAIN; m_trees_contiguous && i < updated_count; ++i)
+    {
+        if (i - m_update_splits.back() >= UPDATE_GRAIN && m_parents[m_updated[i]] == NO_PARENT)
+        {
+            m_update_splits.push_back(i);
+        }
+    }
+    m_update_splits.push_back(updated_count);
+
+    const auto split_count = static_cast<std::uint32_t>(m_update_splits.size() - 1);
+    jobs.parallel_for(split_count, 1, [this](const std::uint32_t begin, const std::uint32_t end) {
+        const auto first = m_update_splits[begin];
+        const auto nodes = std::span(m_updated).subspan(first, m_update_splits[end] - first);
+        multiply_world_matrices(nodes, m_parents.data(), m_local.data(), m_world.data());
+    });
+
+    for (const auto node : m_updated)
+    {
+        m_dirty[node] = 0;
+    }
+    m_first_dirty = node_count;
+    return m_updated;
+}
+
+std::uint32_t SceneGraph::get_node_count() const
+{
+    return static_cast<std::uint32_t>(m_parents.size());
+}
+
+std::uint32_t SceneGraph::get_parent(const std::uint32_t node) const
+{
+    return m_parents[node];
+}
+
+const glm::mat4 &SceneGraph::get_local(const std::uint32_t node) const
+{
+    return m_local[node];
+}
+
+const glm::mat4 &SceneGraph::get_world(const std::uint32_t node) const
+{
+    return m_world[node];
+}
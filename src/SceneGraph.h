@@ -0,0 +1,59 @@
+#ifndef SCENE_GRAPH_H
+#define SCENE_GRAPH_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "JobSystem.h"
+
+// A transform hierarchy stored as parallel arrays indexed by node. Nodes are only ever appended
+// after their parent, so the world matrices can be updated in a single forward pass, and the
+// nodes of a subtree that was added depth first are contiguous.
+class SceneGraph
+{
+  public:
+    static constexpr std::uint32_t NO_PARENT = ~0u;
+    // Updated nodes per job when the trees are updated in parallel.
+    static constexpr std::uint32_t UPDATE_GRAIN = 4096;
+
+  private:
+    std::vector<std::uint32_t> m_parents;
+    std::vector<glm::mat4> m_local;
+    std::vector<glm::mat4> m_world;
+    // Set when the local matrix of a node changed, and during an update for all its descendants.
+    std::vector<std::uint8_t> m_dirty;
+    // The first node that might be dirty, or the node count if none is.
+    std::uint32_t m_first_dirty{};
+    std::vector<std::uint32_t> m_updated;
+    // The last root node, and whether every tree is contiguous, which is what allows updating
+    // the trees in parallel.
+    std::uint32_t m_last_root{};
+    bool m_trees_contiguous{true};
+    // Where the updated nodes are split between jobs, always at a root.
+    std::vector<std::uint32_t> m_update_splits;
+
+  public:
+    explicit SceneGraph() = default;
+    SceneGraph(const SceneGraph &) = delete;
+    const SceneGraph &operator=(const SceneGraph &) = delete;
+
+    // Adds a node and computes its world matrix right away. The parent must have been added
+    // before, or be NO_PARENT for a root node.
+    std::uint32_t add_node(std::uint32_t parent, const glm::mat4 &local);
+    void set_local(std::uint32_t node, const glm::mat4 &local);
+
+    // Recomputes the world matrices of the nodes whose local matrix changed and of all their
+    // descendants, separate trees in parallel. Returns those nodes in ascending order, valid until
+    // the next update.
+    std::span<const std::uint32_t> update(JobSystem &jobs);
+
+    [[nodiscard]] std::uint32_t get_node_count() const;
+    [[nodiscard]] std::uint32_t get_parent(std::uint32_t node) const;
+    [[nodiscard]] const glm::mat4 &get_local(std::uint32_t node) const;
+    [[nodiscard]] const glm::mat4 &get_world(std::uint32_t node) const;
+};
+
+#endif // SCENE_GRAPH_H
@@ -1,103 +1,799 @@
 #include "ShaderProgram.h"
 
-#include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
+#include <fmt/format.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <spdlog/spdlog.h>
+
+#include "GLState.h"
+#include "ProgramBinaryCache.h"
+
+namespace
+{
+constexpr GLuint EMPTY_SLOT = ~0u;
+
+bool parallel_compile = false;
 
-ShaderProgram::ShaderProgram() : m_program(glCreateProgram())
+std::string read_file(const std::filesystem::path &path)
 {
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        throw std::runtime_error(
+            fmt::format("failed to open shader source file '{}'", path.string())
+        );
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
 }
 
-ShaderProgram::~ShaderProgram()
+std::string get_shader_log(const GLuint shader)
 {
-    glDeleteProgram(m_program);
+    GLint len;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &len);
+
+    std::string log;
+    log.resize(len);
+    glGetShaderInfoLog(shader, len, nullptr, log.data());
+    return log;
 }
 
-void ShaderProgram::attach_shader(GLenum shader_type, const std::string &filepath)
+std::string get_program_log(const GLuint program)
+{
+    GLint len;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &len);
+
+    std::string log;
+    log.resize(len);
+    glGetProgramInfoLog(program, len, nullptr, log.data());
+    return log;
+}
+
+std::uint32_t fnv1a(const std::string_view name)
 {
-    std::ifstream shader_file(filepath);
-    if (!shader_file.is_open())
+    std::uint32_t hash = 2166136261u;
+    for (const auto c : name)
     {
-        throw std::runtime_error(fmt::format("failed to open shader source file '{}'", filepath));
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 16777619u;
     }
-    std::stringstream ss;
-    ss << shader_file.rdbuf();
-    std::string shader_src = ss.str();
-    const auto *shader_src_c = shader_src.c_str();
+    return hash;
+}
 
-    auto shader = glCreateShader(shader_type);
-    glShaderSource(shader, 1, &shader_src_c, nullptr);
-    glCompileShader(shader);
+void insert_slot(std::vector<GLuint> &table, const std::uint32_t hash, const GLuint slot)
+{
+    const auto mask = table.size() - 1;
+    auto i = hash & mask;
+    while (table[i] != EMPTY_SLOT)
+    {
+        i = (i + 1) & mask;
+    }
+    table[i] = slot;
+}
 
-    GLint success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success)
+std::size_t uniform_type_size(const GLenum type)
+{
+    switch (type)
     {
-        GLint len;
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &len);
+        case GL_FLOAT_VEC2:
+        case GL_INT_VEC2:
+        case GL_UNSIGNED_INT_VEC2:
+            return 8;
+        case GL_FLOAT_VEC3:
+        case GL_INT_VEC3:
+        case GL_UNSIGNED_INT_VEC3:
+            return 12;
+        case GL_FLOAT_VEC4:
+        case GL_INT_VEC4:
+        case GL_UNSIGNED_INT_VEC4:
+            return 16;
+        case GL_FLOAT_MAT3:
+            return 36;
+        case GL_FLOAT_MAT4:
+            return 64;
+        default:
+            // Scalars, samplers and images.
+            return 4;
+    }
+}
+} // namespace
 
-        std::string log;
-        log.resize(len);
-        glGetShaderInfoLog(shader, len, nullptr, log.data());
+ShaderProgram::ShaderProgram() : m_program(ProgramObject::create())
+{
+}
 
-        throw std::runtime_error{log};
+void ShaderProgram::enable_parallel_compile(const PFNGLMAXSHADERCOMPILERTHREADSKHRPROC max_threads)
+{
+    if (max_threads)
+    {
+        // Let the driver pick the number of threads.
+        max_threads(0xFFFFFFFF);
+        parallel_compile = true;
     }
+}
+
+void ShaderProgram::define(const std::string_view name, const std::string_view value)
+{
+    m_defines += fmt::format("#define {} {}\n", name, value);
+    m_variant += m_variant.empty() ? "" : " ";
+    m_variant += name;
+}
 
-    glAttachShader(m_program, shader);
+void ShaderProgram::attach_shader(GLenum shader_type, const std::string &filepath)
+{
+    Stage stage{
+        .type = shader_type,
+        .path = std::filesystem::path(filepath).lexically_normal(),
+    };
+    preprocess(stage);
+    m_stages.push_back(std::move(stage));
 }
 
 void ShaderProgram::link()
 {
-    glLinkProgram(m_program);
+    auto &cache = ProgramBinaryCache::get();
+    const auto key = make_cache_key();
 
-    GLint success;
-    glGetProgramiv(m_program, GL_LINK_STATUS, &success);
-    if (!success)
+    if (!cache.load(m_program.get(), key))
     {
-        GLint len;
-        glGetProgramiv(m_program, GL_INFO_LOG_LENGTH, &len);
+        const auto start = std::chrono::steady_clock::now();
+        compile_and_link();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const auto compile_time = std::chrono::duration<double, std::milli>(elapsed).count();
+
+        cache.record_compile(compile_time);
+        cache.store(m_program.get(), key, compile_time);
+    }
 
-        std::string log;
-        log.resize(len);
-        glGetProgramInfoLog(m_program, len, nullptr, log.data());
+    reflect();
+}
 
-        throw std::runtime_error{log};
+void ShaderProgram::use()
+{
+    GLState::get().use_program(m_program.get());
+}
+
+const ShaderProgram::Block *ShaderProgram::find_block(const std::string_view name) const
+{
+    const auto block = std::ranges::find(m_blocks, name, &Block::name);
+    return block != m_blocks.end() ? &*block : nullptr;
+}
+
+void ShaderProgram::check_block(
+    const std::string_view name, const GLint binding, const std::size_t size
+) const
+{
+    const auto *block = find_block(name);
+    if (!block)
+    {
+        return;
+    }
+    if (block->binding != binding)
+    {
+        throw std::runtime_error(fmt::format(
+            "block '{}' of program {} is bound to {} instead of {}",
+            name,
+            m_program.get(),
+            block->binding,
+            binding
+        ));
+    }
+    if (static_cast<std::size_t>(block->data_size) > size)
+    {
+        throw std::runtime_error(fmt::format(
+            "block '{}' of program {} is {} bytes, but only {} are provided",
+            name,
+            m_program.get(),
+            block->data_size,
+            size
+        ));
     }
+}
 
-    for (const auto shader : m_shaders)
+void ShaderProgram::set_uniform(const UniformHandle<int> handle, const int data)
+{
+    if (update_value(handle.m_slot, &data, sizeof(data)))
     {
-        glDeleteShader(shader);
+        glProgramUniform1i(m_program.get(), m_uniforms[handle.m_slot].location, data);
     }
 }
 
-void ShaderProgram::use()
+void ShaderProgram::set_uniform(const UniformHandle<bool> handle, const bool data)
+{
+    const GLint value = data;
+    if (update_value(handle.m_slot, &value, sizeof(value)))
+    {
+        glProgramUniform1i(m_program.get(), m_uniforms[handle.m_slot].location, value);
+    }
+}
+
+void ShaderProgram::set_uniform(const UniformHandle<GLuint> handle, const GLuint data)
+{
+    if (update_value(handle.m_slot, &data, sizeof(data)))
+    {
+        glProgramUniform1ui(m_program.get(), m_uniforms[handle.m_slot].location, data);
+    }
+}
+
+void ShaderProgram::set_uniform(const UniformHandle<float> handle, const float data)
+{
+    if (update_value(handle.m_slot, &data, sizeof(data)))
+    {
+        glProgramUniform1f(m_program.get(), m_uniforms[handle.m_slot].location, data);
+    }
+}
+
+void ShaderProgram::set_uniform(const UniformHandle<glm::vec2> handle, const glm::vec2 &data)
+{
+    if (update_value(handle.m_slot, glm::value_ptr(data), sizeof(data)))
+    {
+        glProgramUniform2fv(
+            m_program.get(),
+            m_uniforms[handle.m_slot].location,
+            1,
+            glm::value_ptr(data)
+        );
+    }
+}
+
+void ShaderProgram::set_uniform(const UniformHandle<glm::vec3> handle, const glm::vec3 &data)
+{
+    if (update_value(handle.m_slot, glm::value_ptr(data), sizeof(data)))
+    {
+        glProgramUniform3fv(
+            m_program.get(),
+            m_uniforms[handle.m_slot].location,
+            1,
+            glm::value_ptr(data)
+        );
+    }
+}
+
+void ShaderProgram::set_uniform(const UniformHandle<glm::vec4> handle, const glm::vec4 &data)
+{
+    if (update_value(handle.m_slot, glm::value_ptr(data), sizeof(data)))
+    {
+        glProgramUniform4fv(
+            m_program.get(),
+            m_uniforms[handle.m_slot].location,
+            1,
+            glm::value_ptr(data)
+        );
+    }
+}
+
+void ShaderProgram::set_uniform(
+    const UniformHandle<std::span<const glm::vec4>> handle, const std::span<const glm::vec4> data
+)
+{
+    if (!handle.is_valid() || data.empty())
+    {
+        return;
+    }
+    const auto count = std::min<std::size_t>(data.size(), m_uniforms[handle.m_slot].array_size);
+    if (update_value(handle.m_slot, data.data(), count * sizeof(glm::vec4)))
+    {
+        glProgramUniform4fv(
+            m_program.get(),
+            m_uniforms[handle.m_slot].location,
+            static_cast<GLsizei>(count),
+            glm::value_ptr(data.front())
+        );
+    }
+}
+
+void ShaderProgram::set_uniform(const UniformHandle<glm::mat4> handle, const glm::mat4 &data)
+{
+    if (update_value(handle.m_slot, glm::value_ptr(data), sizeof(data)))
+    {
+        glProgramUniformMatrix4fv(
+            m_program.get(),
+            m_uniforms[handle.m_slot].location,
+            1,
+            GL_FALSE,
+            glm::value_ptr(data)
+        );
+    }
+}
+
+bool ShaderProgram::depends_on(const std::filesystem::path &path) const
+{
+    const auto normal = path.lexically_normal();
+    return std::ranges::any_of(m_stages, [&](const auto &stage) {
+        return stage.path == normal ||
+               std::ranges::find(stage.includes, normal) != stage.includes.end();
+    });
+}
+
+void ShaderProgram::begin_reload()
+{
+    cancel_reload();
+
+    Build build{.program = ProgramObject::create(), .stages = m_stages};
+    try
+    {
+        for (auto &stage : build.stages)
+        {
+            preprocess(stage);
+        }
+    }
+    catch (const std::runtime_error &error)
+    {
+        m_error = error.what();
+        return;
+    }
+
+    start_compile(build);
+    m_pending = std::move(build);
+}
+
+bool ShaderProgram::poll_reload()
+{
+    if (!m_pending)
+    {
+        return false;
+    }
+
+    auto &build = *m_pending;
+    if (!build.linking)
+    {
+        if (!std::ranges::all_of(build.shaders, [](const auto &shader) {
+                return is_complete(shader.get(), false);
+            }))
+        {
+            return false;
+        }
+        if (auto error = finish_compile(build); !error.empty())
+        {
+            m_error = std::move(error);
+            cancel_reload();
+            return true;
+        }
+        return false;
+    }
+
+    if (!is_complete(build.program.get(), true))
+    {
+        return false;
+    }
+    if (auto error = finish_link(build); !error.empty())
+    {
+        m_error = std::move(error);
+        cancel_reload();
+        return true;
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - build.start;
+    const auto compile_time = std::chrono::duration<double, std::milli>(elapsed).count();
+
+    // Swap in the new program. Uniform handles stay valid, since reflecting only adds slots.
+    m_program = std::move(build.program);
+    m_stages = std::move(build.stages);
+    m_pending.reset();
+    m_error.clear();
+    ++m_reload_count;
+    reflect();
+
+    ProgramBinaryCache::get().store(m_program.get(), make_cache_key(), compile_time);
+    return true;
+}
+
+bool ShaderProgram::is_reloading() const
+{
+    return m_pending.has_value();
+}
+
+const std::string &ShaderProgram::get_error() const
+{
+    return m_error;
+}
+
+std::string ShaderProgram::get_name() const
+{
+    if (m_stages.empty())
+    {
+        return {};
+    }
+    const auto name = m_stages.back().path.filename().string();
+    return m_variant.empty() ? name : fmt::format("{} ({})", name, m_variant);
+}
+
+std::uint32_t ShaderProgram::get_reload_count() const
+{
+    return m_reload_count;
+}
+
+void ShaderProgram::preprocess(Stage &stage) const
+{
+    std::string source;
+    stage.includes.clear();
+    append_source(source, stage, stage.path, 0);
+    stage.source = std::move(source);
+}
+
+void ShaderProgram::append_source(
+    std::string &source, Stage &stage, const std::filesystem::path &path, const int source_index
+) const
+{
+    std::istringstream file(read_file(path));
+    std::string line;
+    for (auto line_number = 1; std::getline(file, line); ++line_number)
+    {
+        const auto directive = std::string_view(line).substr(
+            std::min(line.find_first_not_of(" \t"), line.size())
+        );
+
+        if (directive.starts_with("#version"))
+        {
+            // Defines have to follow the version, which has to come first.
+            source += line;
+            source += '\n';
+            source += m_defines;
+            source += fmt::format("#line {} {}\n", line_number + 1, source_index);
+        }
+        else if (directive.starts_with("#include"))
+        {
+            const auto first = directive.find('"');
+            const auto last = directive.rfind('"');
+            if (first == std::string_view::npos || first == last)
+            {
+                throw std::runtime_error(
+                    fmt::format("{}({}): malformed #include", path.string(), line_number)
+                );
+            }
+            const auto name = directive.substr(first + 1, last - first - 1);
+            auto include = (path.parent_path() / name).lexically_normal();
+            if (std::ranges::find(stage.includes, include) == stage.includes.end())
+            {
+                stage.includes.push_back(include);
+                const auto include_index = static_cast<int>(stage.includes.size());
+                source += fmt::format("#line 1 {}\n", include_index);
+                append_source(source, stage, include, include_index);
+            }
+            source += fmt::format("#line {} {}\n", line_number + 1, source_index);
+        }
+        else
+        {
+            source += line;
+            source += '\n';
+        }
+    }
+}
+
+std::uint64_t ShaderProgram::make_cache_key() const
+{
+    std::vector<std::string_view> key_parts;
+    for (const auto &stage : m_stages)
+    {
+        key_parts.emplace_back(reinterpret_cast<const char *>(&stage.type), sizeof(stage.type));
+        key_parts.emplace_back(stage.source);
+    }
+    return ProgramBinaryCache::get().make_key(key_parts);
+}
+
+void ShaderProgram::compile_and_link()
+{
+    // The build links into the current program and hands it back, whether linking succeeded or
+    // not.
+    Build build{.program = std::move(m_program), .stages = m_stages};
+    start_compile(build);
+    auto error = finish_compile(build);
+    if (error.empty())
+    {
+        error = finish_link(build);
+    }
+    m_program = std::move(build.program);
+    if (!error.empty())
+    {
+        throw std::runtime_error(error);
+    }
+}
+
+void ShaderProgram::cancel_reload()
+{
+    m_pending.reset();
+}
+
+void ShaderProgram::start_compile(Build &build)
+{
+    for (const auto &stage : build.stages)
+    {
+        const auto *source = stage.source.c_str();
+        auto shader = ShaderObject::create(stage.type);
+        glShaderSource(shader.get(), 1, &source, nullptr);
+        glCompileShader(shader.get());
+        build.shaders.push_back(std::move(shader));
+    }
+}
+
+std::string ShaderProgram::finish_compile(Build &build)
+{
+    for (std::size_t i = 0; i < build.shaders.size(); ++i)
+    {
+        GLint success;
+        glGetShaderiv(build.shaders[i].get(), GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            const auto &stage = build.stages[i];
+            auto error = fmt::format(
+                "failed to compile '{}':\n{}",
+                stage.path.string(),
+                get_shader_log(build.shaders[i].get())
+            );
+            for (std::size_t j = 0; j < stage.includes.size(); ++j)
+            {
+                error += fmt::format("source {}: '{}'\n", j + 1, stage.includes[j].string());
+            }
+            return error;
+        }
+    }
+
+    for (const auto &shader : build.shaders)
+    {
+        glAttachShader(build.program.get(), shader.get());
+    }
+    glProgramParameteri(build.program.get(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(build.program.get());
+    build.linking = true;
+    return {};
+}
+
+std::string ShaderProgram::finish_link(Build &build)
 {
-    glUseProgram(m_program);
+    for (const auto &shader : build.shaders)
+    {
+        glDetachShader(build.program.get(), shader.get());
+    }
+    build.shaders.clear();
+
+    GLint success;
+    glGetProgramiv(build.program.get(), GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        return fmt::format(
+            "failed to link '{}':\n{}",
+            get_name(),
+            get_program_log(build.program.get())
+        );
+    }
+    return {};
 }
 
-void ShaderProgram::set_uniform(const std::string &name, const int data)
+bool ShaderProgram::is_complete(const GLuint object, const bool program)
 {
-    glUniform1i(glGetUniformLocation(m_program, name.c_str()), data);
+    if (!parallel_compile)
+    {
+        return true;
+    }
+    GLint complete = GL_FALSE;
+    if (program)
+    {
+        glGetProgramiv(object, GL_COMPLETION_STATUS_KHR, &complete);
+    }
+    else
+    {
+        glGetShaderiv(object, GL_COMPLETION_STATUS_KHR, &complete);
+    }
+    return complete == GL_TRUE;
+}
+
+bool ShaderProgram::is_opaque_type(const GLenum type)
+{
+    switch (type)
+    {
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_SHADOW:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_CUBE_SHADOW:
+        case GL_INT_SAMPLER_2D:
+        case GL_UNSIGNED_INT_SAMPLER_2D:
+        case GL_IMAGE_2D:
+        case GL_IMAGE_3D:
+        case GL_IMAGE_CUBE:
+        case GL_IMAGE_2D_ARRAY:
+            return true;
+        default:
+            return false;
+    }
 }
 
-void ShaderProgram::set_uniform(const std::string &name, const float data)
+GLuint ShaderProgram::resolve_uniform(const std::string_view name, bool (*accepts)(GLenum))
 {
-    glUniform1f(glGetUniformLocation(m_program, name.c_str()), data);
+    const auto slot = find_or_add_uniform(name);
+    const auto &uniform = m_uniforms[slot];
+    if (uniform.location == -1)
+    {
+        spdlog::debug("uniform '{}' is not active in program {}", name, m_program.get());
+    }
+    else if (!accepts(uniform.type))
+    {
+        throw std::runtime_error(fmt::format(
+            "uniform '{}' of program {} has type 0x{:x}, which does not match its handle",
+            name,
+            m_program.get(),
+            uniform.type
+        ));
+    }
+    return slot;
 }
 
-void ShaderProgram::set_uniform(const std::string &name, const glm::vec3 &data)
+GLuint ShaderProgram::find_or_add_uniform(const std::string_view name)
 {
-    glUniform3f(glGetUniformLocation(m_program, name.c_str()), data.x, data.y, data.z);
+    const auto hash = fnv1a(name);
+
+    if (!m_uniform_table.empty())
+    {
+        const auto mask = m_uniform_table.size() - 1;
+        for (auto i = hash & mask;; i = (i + 1) & mask)
+        {
+            const auto slot = m_uniform_table[i];
+            if (slot == EMPTY_SLOT)
+            {
+                break;
+            }
+            if (m_uniforms[slot].hash == hash && m_uniforms[slot].name == name)
+            {
+                return slot;
+            }
+        }
+    }
+
+    const auto slot = static_cast<GLuint>(m_uniforms.size());
+    m_uniforms.push_back(Uniform{.name = std::string(name), .hash = hash});
+
+    // Keep the load factor at or below one half.
+    if (m_uniforms.size() * 2 > m_uniform_table.size())
+    {
+        m_uniform_table.assign(std::max<std::size_t>(16, m_uniform_table.size() * 2), EMPTY_SLOT);
+        for (GLuint i = 0; i < m_uniforms.size(); ++i)
+        {
+            insert_slot(m_uniform_table, m_uniforms[i].hash, i);
+        }
+    }
+    else
+    {
+        insert_slot(m_uniform_table, hash, slot);
+    }
+    return slot;
 }
 
-void ShaderProgram::set_uniform(const std::string &name, const glm::mat4 &data)
+void ShaderProgram::reflect()
 {
-    glUniformMatrix4fv(
-        glGetUniformLocation(m_program, name.c_str()),
-        1,
-        GL_FALSE,
-        glm::value_ptr(data)
+    for (auto &uniform : m_uniforms)
+    {
+        uniform.location = -1;
+        uniform.cached = false;
+    }
+    m_blocks.clear();
+
+    GLint uniform_count = 0;
+    glGetProgramInterfaceiv(m_program.get(), GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniform_count);
+    GLint max_name_length = 0;
+    glGetProgramInterfaceiv(m_program.get(), GL_UNIFORM, GL_MAX_NAME_LENGTH, &max_name_length);
+    std::string name(std::max(max_name_length, 1), '\0');
+
+    constexpr std::array<GLenum, 4> uniform_properties{
+        GL_BLOCK_INDEX,
+        GL_LOCATION,
+        GL_TYPE,
+        GL_ARRAY_SIZE,
+    };
+    for (GLint i = 0; i < uniform_count; ++i)
+    {
+        std::array<GLint, uniform_properties.size()> values{};
+        glGetProgramResourceiv(
+            m_program.get(),
+            GL_UNIFORM,
+            i,
+            uniform_properties.size(),
+            uniform_properties.data(),
+            values.size(),
+            nullptr,
+            values.data()
+        );
+        const auto [block_index, location, type, array_size] = values;
+        // Members of uniform blocks have no location.
+        if (block_index != -1 || location == -1)
+        {
+            continue;
+        }
+
+        GLsizei length = 0;
+        glGetProgramResourceName(
+            m_program.get(),
+            GL_UNIFORM,
+            i,
+            static_cast<GLsizei>(name.size()),
+            &length,
+            name.data()
+        );
+        auto uniform_name = std::string_view(name.data(), length);
+        if (uniform_name.ends_with("[0]"))
+        {
+            uniform_name.remove_suffix(3);
+        }
+
+        auto &uniform = m_uniforms[find_or_add_uniform(uniform_name)];
+        uniform.location = location;
+        uniform.type = static_cast<GLenum>(type);
+        uniform.array_size = array_size;
+        uniform.value.resize(uniform_type_size(uniform.type) * array_size);
+    }
+
+    for (const auto interface : {GL_UNIFORM_BLOCK, GL_SHADER_STORAGE_BLOCK})
+    {
+        GLint block_count = 0;
+        glGetProgramInterfaceiv(m_program.get(), interface, GL_ACTIVE_RESOURCES, &block_count);
+        glGetProgramInterfaceiv(m_program.get(), interface, GL_MAX_NAME_LENGTH, &max_name_length);
+        name.assign(std::max(max_name_length, 1), '\0');
+
+        constexpr std::array<GLenum, 2> block_properties{GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+        for (GLint i = 0; i < block_count; ++i)
+        {
+            std::array<GLint, block_properties.size()> values{};
+            glGetProgramResourceiv(
+                m_program.get(),
+                interface,
+                i,
+                block_properties.size(),
+                block_properties.data(),
+                values.size(),
+                nullptr,
+                values.data()
+            );
+            GLsizei length = 0;
+            glGetProgramResourceName(
+                m_program.get(),
+                interface,
+                i,
+                static_cast<GLsizei>(name.size()),
+                &length,
+                name.data()
+            );
+            m_blocks.push_back(Block{
+                .name = std::string(name.data(), length),
+                .interface = static_cast<GLenum>(interface),
+                .binding = values[0],
+                .data_size = values[1],
+            });
+        }
+    }
+
+    spdlog::debug(
+        "program {}: {} active uniforms, {} blocks",
+        m_program.get(),
+        std::ranges::count_if(m_uniforms, [](const auto &u) { return u.location != -1; }),
+        m_blocks.size()
     );
 }
+
+bool ShaderProgram::update_value(const GLuint slot, const void *data, const std::size_t size)
+{
+    if (slot >= m_uniforms.size())
+    {
+        return false;
+    }
+    auto &uniform = m_uniforms[slot];
+    if (uniform.location == -1)
+    {
+        return false;
+    }
+
+    const auto bytes = std::min(size, uniform.value.size());
+    if (uniform.cached && std::memcmp(uniform.value.data(), data, bytes) == 0)
+    {
+        return false;
+    }
+    std::memcpy(uniform.value.data(), data, bytes);
+    uniform.cached = true;
+    return true;
+}
@@ -1,31 +1,231 @@
 #ifndef SHADER_PROGRAM_H
 #define SHADER_PROGRAM_H
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "GLObject.h"
+
+// GL_KHR_parallel_shader_compile is not part of the generated loader.
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+typedef void(APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+#endif
+
+// A uniform of a specific ShaderProgram, resolved once by name. Setting a uniform through a handle
+// does not look anything up by name. Handles stay valid when the program is linked again.
+template <typename T> class UniformHandle
+{
+    static constexpr GLuint INVALID = ~0u;
+
+    GLuint m_slot{INVALID};
+
+    friend class ShaderProgram;
+
+    explicit UniformHandle(const GLuint slot) : m_slot(slot)
+    {
+    }
+
+  public:
+    UniformHandle() = default;
+
+    [[nodiscard]] bool is_valid() const
+    {
+        return m_slot != INVALID;
+    }
+};
+
 class ShaderProgram
 {
-    GLuint m_program;
-    std::vector<GLuint> m_shaders{};
+  public:
+    struct Block
+    {
+        std::string name;
+        GLenum interface;
+        GLint binding;
+        GLint data_size;
+    };
+
+  private:
+    struct Uniform
+    {
+        std::string name;
+        std::uint32_t hash;
+        GLint location{-1};
+        GLenum type{GL_NONE};
+        GLint array_size{};
+        // Last value set, so that setting the same value again does not reach the driver.
+        std::vector<std::byte> value;
+        bool cached{false};
+    };
+
+    struct Stage
+    {
+        GLenum type;
+        std::filesystem::path path;
+        // Preprocessed source, with includes expanded and defines inserted.
+        std::string source;
+        // Files included by the stage. Include i has source string number i + 1 in compiler logs.
+        std::vector<std::filesystem::path> includes{};
+    };
+
+    // A program that is being compiled and linked in the background while the current one keeps
+    // being used.
+    struct Build
+    {
+        ProgramObject program;
+        std::vector<Stage> stages;
+        std::vector<ShaderObject> shaders{};
+        bool linking{false};
+        std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+    };
+
+    ProgramObject m_program;
+    std::string m_defines;
+    // The names of the defines, to tell variants of the same stages apart.
+    std::string m_variant;
+    std::vector<Stage> m_stages;
+    std::optional<Build> m_pending;
+    std::string m_error;
+    std::uint32_t m_reload_count{};
+
+    // Uniforms are never removed, so that handles stay valid. Uniforms that are not active in the
+    // linked program have a location of -1.
+    std::vector<Uniform> m_uniforms;
+    // Open addressing table with linear probing, mapping name hashes to indices into m_uniforms.
+    std::vector<GLuint> m_uniform_table;
+    std::vector<Block> m_blocks;
 
   public:
+    // Called once after loading GL if GL_KHR_parallel_shader_compile is available, so that reloads
+    // do not block on the compiler.
+    static void enable_parallel_compile(PFNGLMAXSHADERCOMPILERTHREADSKHRPROC max_threads);
+
     explicit ShaderProgram();
     ShaderProgram(const ShaderProgram &) = delete;
     const ShaderProgram &operator=(const ShaderProgram &) = delete;
-    ~ShaderProgram();
 
+    // Adds a define to all stages attached afterwards.
+    void define(std::string_view name, std::string_view value = "1");
+    // Reads and preprocesses the source of a stage. It is compiled by `link`. Lines of the form
+    // `#include "file"` are replaced by the file, relative to the including file. Each file is
+    // included at most once per stage.
     void attach_shader(GLenum shader_type, const std::string &filepath);
+    // Loads the program from the binary cache, or compiles and links it if it is not cached, and
+    // reflects its active uniforms and uniform/shader storage blocks.
     void link();
     void use();
 
-    void set_uniform(const std::string &name, int data);
-    void set_uniform(const std::string &name, float data);
-    void set_uniform(const std::string &name, const glm::vec3 &data);
-    void set_uniform(const std::string &name, const glm::mat4 &data);
+    [[nodiscard]] bool depends_on(const std::filesystem::path &path) const;
+    // Starts compiling the stages from their files again. The current program stays in use until
+    // `poll_reload` swaps in the new one after it linked successfully.
+    void begin_reload();
+    // Returns true once a reload has finished, successfully or with an error.
+    bool poll_reload();
+    [[nodiscard]] bool is_reloading() const;
+    // The error of the last failed reload, empty if the last reload succeeded.
+    [[nodiscard]] const std::string &get_error() const;
+    [[nodiscard]] std::string get_name() const;
+    [[nodiscard]] std::uint32_t get_reload_count() const;
+
+    // Returns a handle to the uniform with the given name. The handle does nothing if the uniform
+    // is not active, e.g. because the compiler removed it.
+    template <typename T> [[nodiscard]] UniformHandle<T> get_uniform(std::string_view name)
+    {
+        return UniformHandle<T>(resolve_uniform(name, accepts_type<T>));
+    }
+
+    [[nodiscard]] const Block *find_block(std::string_view name) const;
+    // Throws if the block is active but not at `binding`, or larger than `size` bytes.
+    void check_block(std::string_view name, GLint binding, std::size_t size) const;
+
+    void set_uniform(UniformHandle<int> handle, int data);
+    void set_uniform(UniformHandle<bool> handle, bool data);
+    void set_uniform(UniformHandle<GLuint> handle, GLuint data);
+    void set_uniform(UniformHandle<float> handle, float data);
+    void set_uniform(UniformHandle<glm::vec2> handle, const glm::vec2 &data);
+    void set_uniform(UniformHandle<glm::vec3> handle, const glm::vec3 &data);
+    void set_uniform(UniformHandle<glm::vec4> handle, const glm::vec4 &data);
+    void set_uniform(
+        UniformHandle<std::span<const glm::vec4>> handle, std::span<const glm::vec4> data
+    );
+    void set_uniform(UniformHandle<glm::mat4> handle, const glm::mat4 &data);
+
+  private:
+    template <typename T> static bool accepts_type(const GLenum type)
+    {
+        if constexpr (std::is_same_v<T, int>)
+        {
+            return type == GL_INT || is_opaque_type(type);
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            return type == GL_BOOL || type == GL_INT;
+        }
+        else if constexpr (std::is_same_v<T, GLuint>)
+        {
+            return type == GL_UNSIGNED_INT;
+        }
+        else if constexpr (std::is_same_v<T, float>)
+        {
+            return type == GL_FLOAT;
+        }
+        else if constexpr (std::is_same_v<T, glm::vec2>)
+        {
+            return type == GL_FLOAT_VEC2;
+        }
+        else if constexpr (std::is_same_v<T, glm::vec3>)
+        {
+            return type == GL_FLOAT_VEC3;
+        }
+        else if constexpr (std::is_same_v<T, glm::vec4>)
+        {
+            return type == GL_FLOAT_VEC4;
+        }
+        else if constexpr (std::is_same_v<T, std::span<const glm::vec4>>)
+        {
+            return type == GL_FLOAT_VEC4;
+        }
+        else if constexpr (std::is_same_v<T, glm::mat4>)
+        {
+            return type == GL_FLOAT_MAT4;
+        }
+        else
+        {
+            static_assert(sizeof(T) == 0, "unsupported uniform type");
+        }
+    }
+    static bool is_opaque_type(GLenum type);
+
+    void preprocess(Stage &stage) const;
+    void append_source(
+        std::string &source, Stage &stage, const std::filesystem::path &path, int source_index
+    ) const;
+    [[nodiscard]] std::uint64_t make_cache_key() const;
+    void compile_and_link();
+    void cancel_reload();
+    static void start_compile(Build &build);
+    // Both return an error message, or an empty string on success.
+    std::string finish_compile(Build &build);
+    std::string finish_link(Build &build);
+    static bool is_complete(GLuint object, bool program);
+    GLuint resolve_uniform(std::string_view name, bool (*accepts)(GLenum));
+    GLuint find_or_add_uniform(std::string_view name);
+    void reflect();
+    // Stores the value of the uniform and returns whether it changed and has to be set.
+    bool update_value(GLuint slot, const void *data, std::size_t size);
 };
 
 #endif // SHADER_PROGRAM_H
@@ -0,0 +1,140 @@
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include "ShaderProgram.h"
+#include "ShaderWatcher.h"
+
+// Bit i enables the i-th feature of a ShaderVariants.
+using ShaderFeatures = std::uint32_t;
+
+// Variants of a shader program that differ in a set of features. Each enabled feature is passed to
+// the stages as a define, so that code for disabled features is removed by the compiler instead of
+// being branched over at runtime. A variant is compiled the first time it is requested and kept
+// afterwards, together with its uniform handles. If a variant fails to compile, the variant that
+// was returned last is used in its place and the error is kept for `get_error`, until a shader
+// file changes and the variant is compiled again.
+template <typename Uniforms> class ShaderVariants
+{
+  public:
+    struct Variant
+    {
+        ShaderProgram program;
+        Uniforms uniforms{};
+    };
+
+    struct Stage
+    {
+        GLenum type;
+        std::string path;
+    };
+
+    // Resolves the uniforms of a variant after it has been linked.
+    using Setup = void (*)(ShaderProgram &program, Uniforms &uniforms);
+
+  private:
+    std::vector<Stage> m_stages;
+    // The define of each feature bit.
+    std::vector<std::string_view> m_features;
+    Setup m_setup;
+    ShaderWatcher &m_watcher;
+    std::unordered_map<ShaderFeatures, std::unique_ptr<Variant>> m_variants;
+    // Not compiled again before the next change in the shader directory, so that a broken variant
+    // does not stall every frame. Any file counts, since the includes of a variant that failed
+    // to compile are not known.
+    std::unordered_set<ShaderFeatures> m_failed;
+    std::uint64_t m_failed_generation{};
+    Variant *m_last{};
+    std::string m_error;
+
+  public:
+    ShaderVariants(
+        std::vector<Stage> stages, std::vector<std::string_view> features, const Setup setup,
+        ShaderWatcher &watcher
+    )
+        : m_stages(std::move(stages)), m_features(std::move(features)), m_setup(setup),
+          m_watcher(watcher)
+    {
+    }
+    ShaderVariants(const ShaderVariants &) = delete;
+    const ShaderVariants &operator=(const ShaderVariants &) = delete;
+
+    // Throws if no variant has been compiled successfully before.
+    Variant &get(const ShaderFeatures features)
+    {
+        if (const auto it = m_variants.find(features); it != m_variants.end())
+        {
+            m_last = it->second.get();
+            return *m_last;
+        }
+        if (!m_failed.empty() && m_watcher.get_generation() != m_failed_generation)
+        {
+            m_failed.clear();
+            m_error.clear();
+        }
+        if (m_last && m_failed.contains(features))
+        {
+            return *m_last;
+        }
+
+        auto variant = std::make_unique<Variant>();
+        try
+        {
+            for (std::size_t i = 0; i < m_features.size(); ++i)
+            {
+                if (features & (1u << i))
+                {
+                    variant->program.define(m_features[i]);
+                }
+            }
+            for (const auto &[type, path] : m_stages)
+            {
+                variant->program.attach_shader(type, path);
+            }
+            variant->program.link();
+            m_setup(variant->program, variant->uniforms);
+        }
+        catch (const std::exception &e)
+        {
+            if (!m_last)
+            {
+                throw;
+            }
+            m_failed.insert(features);
+            m_failed_generation = m_watcher.get_generation();
+            m_error = e.what();
+            spdlog::error("{}", m_error);
+            return *m_last;
+        }
+
+        m_watcher.watch(variant->program);
+        m_last = variant.get();
+        m_variants.emplace(features, std::move(variant));
+        return *m_last;
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_variants.size();
+    }
+
+    // The error of the last variant that failed to compile, empty if none has.
+    [[nodiscard]] const std::string &get_error() const
+    {
+        return m_error;
+    }
+};
+
+#endif // SHADER_VARIANTS_H
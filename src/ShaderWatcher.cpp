@@ -0,0 +1,136 @@
+#include "ShaderWatcher.h"
+
+#include <algorithm>
+#include <array>
+
+#include <spdlog/spdlog.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+ShaderWatcher::ShaderWatcher(std::filesystem::path directory) : m_directory(std::move(directory))
+{
+#ifdef __linux__
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    // Editors often write to a temporary file and rename it over the original.
+    if (m_inotify == -1 ||
+        inotify_add_watch(m_inotify, m_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1)
+    {
+        spdlog::warn("failed to watch '{}', shader hot reload is disabled", m_directory.string());
+    }
+#endif
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+#ifdef __linux__
+    if (m_inotify != -1)
+    {
+        close(m_inotify);
+    }
+#endif
+}
+
+void ShaderWatcher::watch(ShaderProgram &program)
+{
+    m_programs.push_back(&program);
+}
+
+void ShaderWatcher::update()
+{
+    const auto changes = poll_changes();
+    if (!changes.empty())
+    {
+        ++m_generation;
+    }
+    for (const auto &path : changes)
+    {
+        for (auto *program : m_programs)
+        {
+            if (program->depends_on(path))
+            {
+                spdlog::info("reloading '{}'", program->get_name());
+                program->begin_reload();
+            }
+        }
+    }
+
+    for (auto *program : m_programs)
+    {
+        if (program->poll_reload())
+        {
+            if (program->get_error().empty())
+            {
+                spdlog::info("reloaded '{}'", program->get_name());
+            }
+            else
+            {
+                spdlog::error("{}", program->get_error());
+            }
+        }
+    }
+}
+
+std::span<ShaderProgram *const> ShaderWatcher::get_programs() const
+{
+    return m_programs;
+}
+
+std::uint64_t ShaderWatcher::get_generation() const
+{
+    return m_generation;
+}
+
+std::vector<std::filesystem::path> ShaderWatcher::poll_changes()
+{
+    std::vector<std::filesystem::path> changes;
+
+#ifdef __linux__
+    if (m_inotify == -1)
+    {
+        return changes;
+    }
+
+    alignas(inotify_event) std::array<char, 4096> buffer;
+    ssize_t length;
+    while ((length = read(m_inotify, buffer.data(), buffer.size())) > 0)
+    {
+        for (auto offset = 0; offset < length;)
+        {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+            if (event->len != 0)
+            {
+                changes.push_back(m_directory / event->name);
+            }
+            offset += static_cast<int>(sizeof(inotify_event) + event->len);
+        }
+    }
+#else
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_last_poll < std::chrono::milliseconds(500))
+    {
+        return changes;
+    }
+    m_last_poll = now;
+
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(m_directory, error))
+    {
+        const auto write_time = entry.last_write_time(error);
+        auto [it, inserted] = m_write_times.try_emplace(entry.path(), write_time);
+        if (!inserted && it->second != write_time)
+        {
+            it->second = write_time;
+            changes.push_back(entry.path());
+        }
+    }
+#endif
+
+    // Writing a file may cause several events.
+    std::ranges::sort(changes);
+    const auto duplicates = std::ranges::unique(changes);
+    changes.erase(duplicates.begin(), duplicates.end());
+    return changes;
+}
@@ -0,0 +1,48 @@
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <map>
+#include <vector>
+
+#include "ShaderProgram.h"
+
+// Watches the shader directory and reloads the programs whose sources changed. Uses inotify on
+// Linux and polls the modification times elsewhere.
+class ShaderWatcher
+{
+    std::filesystem::path m_directory;
+    std::vector<ShaderProgram *> m_programs;
+    std::uint64_t m_generation{};
+
+#ifdef __linux__
+    int m_inotify{-1};
+#else
+    std::map<std::filesystem::path, std::filesystem::file_time_type> m_write_times;
+    std::chrono::steady_clock::time_point m_last_poll{};
+#endif
+
+  public:
+    explicit ShaderWatcher(std::filesystem::path directory);
+    ShaderWatcher(const ShaderWatcher &) = delete;
+    const ShaderWatcher &operator=(const ShaderWatcher &) = delete;
+    ~ShaderWatcher();
+
+    void watch(ShaderProgram &program);
+
+    // Starts reloading the programs affected by changed files and finishes reloads whose
+    // compilation completed. Never waits for the compiler.
+    void update();
+
+    [[nodiscard]] std::span<ShaderProgram *const> get_programs() const;
+    // Incremented by every `update` that saw a file change.
+    [[nodiscard]] std::uint64_t get_generation() const;
+
+  private:
+    [[nodiscard]] std::vector<std::filesystem::path> poll_changes();
+};
+
+#endif // SHADER_WATCHER_H
@@ -1,7 +1,10 @@
 #include "Texture.h"
 
+#include <algorithm>
+#include <bit>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include <fmt/format.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -9,11 +12,35 @@
 #include <spdlog/spdlog.h>
 #include <stb_image.h>
 
-std::shared_ptr<Texture> Texture::from_file_2d(const std::string &filename, const bool is_srgb)
+#include "GLState.h"
+
+namespace
+{
+// The bytes of a texture's storage, assuming that three component texels are padded to four, as
+// drivers usually do.
+GLsizeiptr get_storage_size(
+    const GLenum internal_format, const int width, const int height, const int levels,
+    const int layers = 1
+)
 {
-    // TODO - Look into glTextureStorage (GL_ARB_texture_storage)
-    // https://gamedev.stackexchange.com/questions/134177/whats-the-dsa-version-of-glteximage2d
+    GLsizeiptr texel_size = 4;
+    if (internal_format == GL_RGBA16F || internal_format == GL_RGB16F)
+    {
+        texel_size = 8;
+    }
+
+    GLsizeiptr texels = 0;
+    for (auto level = 0; level < levels; ++level)
+    {
+        texels += static_cast<GLsizeiptr>(std::max(width >> level, 1)) *
+                  std::max(height >> level, 1);
+    }
+    return texels * texel_size * layers;
+}
+} // namespace
 
+Texture Texture::from_file_2d(const std::string &filename, const bool is_srgb)
+{
     int width, height, channels;
     auto *image_data = stbi_load(filename.c_str(), &width, &height, &channels, 0);
 
@@ -22,16 +49,16 @@ std::shared_ptr<Texture> Texture::from_file_2d(const std::string &filename, cons
         throw std::runtime_error(fmt::format("failed to load image '{}'", filename));
     }
 
-    GLint internal_format;
+    GLenum internal_format;
     GLenum format;
     if (channels == 4)
     {
-        internal_format = is_srgb ? GL_SRGB_ALPHA : GL_RGBA;
+        internal_format = is_srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
         format = GL_RGBA;
     }
     else if (channels == 3)
     {
-        internal_format = is_srgb ? GL_SRGB : GL_RGB;
+        internal_format = is_srgb ? GL_SRGB8 : GL_RGB8;
         format = GL_RGB;
     }
     else
@@ -41,56 +68,66 @@ std::shared_ptr<Texture> Texture::from_file_2d(const std::string &filename, cons
         );
     }
 
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    const auto levels = std::bit_width(static_cast<unsigned>(std::max(width, height)));
+
+    auto texture = TextureObject::create(GL_TEXTURE_2D);
+    glTextureStorage2D(texture.get(), levels, internal_format, width, height);
+    texture.set_size(get_storage_size(internal_format, width, height, levels));
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture.get(), GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(texture.get(), GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(texture.get(), GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(texture.get(), GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    glTexImage2D(
-        GL_TEXTURE_2D,
+    glTextureSubImage2D(
+        texture.get(),
+        0,
+        0,
         0,
-        internal_format,
         width,
         height,
-        0,
         format,
         GL_UNSIGNED_BYTE,
         image_data
     );
-
-    glGenerateMipmap(GL_TEXTURE_2D);
+    glGenerateTextureMipmap(texture.get());
 
     stbi_image_free(image_data);
 
-    return std::make_shared<Texture>(texture, GL_TEXTURE_2D);
+    return Texture(std::move(texture), GL_TEXTURE_2D);
 }
 
-std::shared_ptr<Texture> Texture::from_file_cubemap(std::span<const std::string> faces)
+Texture Texture::from_file_cubemap(std::span<const std::string> faces)
 {
     if (faces.size() != 6)
     {
         throw std::runtime_error("not enough faces");
     }
 
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    auto texture = TextureObject::create(GL_TEXTURE_CUBE_MAP);
 
     for (auto i = 0; i < 6; ++i)
     {
         int width, height, channels;
         auto *image_data = stbi_load(faces[i].c_str(), &width, &height, &channels, 3);
-        glTexImage2D(
-            GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
+        if (!image_data)
+        {
+            throw std::runtime_error(fmt::format("failed to load image '{}'", faces[i]));
+        }
+        if (i == 0)
+        {
+            glTextureStorage2D(texture.get(), 1, GL_SRGB8, width, height);
+            texture.set_size(get_storage_size(GL_SRGB8, width, height, 1, 6));
+        }
+        glTextureSubImage3D(
+            texture.get(),
+            0,
             0,
-            GL_SRGB,
+            0,
+            i,
             width,
             height,
-            0,
+            1,
             GL_RGB,
             GL_UNSIGNED_BYTE,
             image_data
@@ -98,76 +135,67 @@ std::shared_ptr<Texture> Texture::from_file_cubemap(std::span<const std::string>
         stbi_image_free(image_data);
     }
 
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture.get(), GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(texture.get(), GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture.get(), GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture.get(), GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture.get(), GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-    return std::make_shared<Texture>(texture, GL_TEXTURE_CUBE_MAP);
+    return Texture(std::move(texture), GL_TEXTURE_CUBE_MAP);
 }
 
-Texture Texture::color_attachment(
-    const int width, const int height, const GLint internal_format, const GLenum format
-)
+Texture Texture::color_attachment(const int width, const int height, const GLenum internal_format)
 {
-    return attachment(width, height, internal_format, format);
+    return attachment(width, height, internal_format);
 }
 
 Texture Texture::depth_attachment(const int width, const int height)
 {
-    return attachment(width, height, GL_DEPTH_COMPONENT, GL_DEPTH_COMPONENT);
+    return attachment(width, height, GL_DEPTH_COMPONENT24);
 }
 
-Texture Texture::attachment(
-    const int width, const int height, const GLint internal_format, const GLenum format
-)
+Texture Texture::depth_pyramid(const int width, const int height, const int levels)
 {
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    auto texture = TextureObject::create(GL_TEXTURE_2D);
+    glTextureStorage2D(texture.get(), levels, GL_R32F, width, height);
+    texture.set_size(get_storage_size(GL_R32F, width, height, levels));
 
-    glTexImage2D(
-        GL_TEXTURE_2D,
-        0,
-        internal_format,
-        width,
-        height,
-        0,
-        format,
-        GL_UNSIGNED_BYTE,
-        nullptr
-    );
+    glTextureParameteri(texture.get(), GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTextureParameteri(texture.get(), GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(texture.get(), GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture.get(), GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return Texture(std::move(texture), GL_TEXTURE_2D);
+}
 
-    constexpr auto border = glm::vec4(0.0, 0.0, 0.0, 1.0);
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, glm::value_ptr(border));
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+Texture Texture::attachment(const int width, const int height, const GLenum internal_format)
+{
+    auto texture = TextureObject::create(GL_TEXTURE_2D);
+    glTextureStorage2D(texture.get(), 1, internal_format, width, height);
+    texture.set_size(get_storage_size(internal_format, width, height, 1));
+
+    glTextureParameteri(texture.get(), GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(texture.get(), GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    constexpr auto border = glm::vec4(0.0, 0.0, 0.0, 1.0);
+    glTextureParameterfv(texture.get(), GL_TEXTURE_BORDER_COLOR, glm::value_ptr(border));
+    glTextureParameteri(texture.get(), GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTextureParameteri(texture.get(), GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 
-    return Texture(texture, GL_TEXTURE_2D);
+    return Texture(std::move(texture), GL_TEXTURE_2D);
 }
 
 void Texture::bind(const GLenum slot)
 {
-    glActiveTexture(slot);
-    glBindTexture(m_target, m_texture);
+    GLState::get().bind_texture(slot - GL_TEXTURE0, m_target, m_texture.get());
 }
 
 GLuint Texture::get_handle() const
 {
-    return m_texture;
-}
-
-Texture::Texture(const GLuint texture, const GLenum target) : m_texture(texture), m_target(target)
-{
+    return m_texture.get();
 }
 
-Texture::~Texture()
+Texture::Texture(TextureObject texture, const GLenum target)
+    : m_texture(std::move(texture)), m_target(target)
 {
-    glDeleteTextures(1, &m_texture);
 }
@@ -1,36 +1,37 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
-#include <memory>
 #include <span>
 #include <string>
 
 #include <glad/glad.h>
 
+#include "GLObject.h"
+
 class Texture
 {
-    GLuint m_texture;
+    TextureObject m_texture;
     GLenum m_target;
 
   public:
-    static std::shared_ptr<Texture> from_file_2d(const std::string &filename, bool is_srgb = true);
-    static std::shared_ptr<Texture> from_file_cubemap(std::span<const std::string> faces);
-    static Texture
-    color_attachment(int width, int height, const GLint internal_format, const GLenum format);
+    static Texture from_file_2d(const std::string &filename, bool is_srgb = true);
+    static Texture from_file_cubemap(std::span<const std::string> faces);
+    static Texture color_attachment(int width, int height, GLenum internal_format);
     static Texture depth_attachment(int width, int height);
+    static Texture depth_pyramid(int width, int height, int levels);
 
-    explicit Texture(GLuint texture, GLenum target);
+    explicit Texture(TextureObject texture, GLenum target);
     Texture(const Texture &) = delete;
     const Texture &operator=(const Texture &) = delete;
-
-    ~Texture();
+    Texture(Texture &&) = default;
+    Texture &operator=(Texture &&) = default;
 
     void bind(GLenum slot);
 
     [[nodiscard]] GLuint get_handle() const;
 
   private:
-    static Texture attachment(int width, int height, GLint internal_format, GLenum format);
+    static Texture attachment(int width, int height, GLenum internal_format);
 };
 
 #endif // TEXTURE_H
@@ -0,0 +1,72 @@
+#include "ThreadScalingBenchmark.h"
+
+#include <spdlog/spdlog.h>
+
+void ThreadScalingBenchmark::start(const std::size_t max_threads)
+{
+    m_thread_counts.clear();
+    for (std::size_t threads = 1; threads < max_threads; threads *= 2)
+    {
+        m_thread_counts.push_back(threads);
+    }
+    m_thread_counts.push_back(max_threads);
+
+    m_run = 0;
+    m_frame = 0;
+    m_sum = 0.0;
+    m_results.clear();
+}
+
+bool ThreadScalingBenchmark::is_running() const
+{
+    return m_run >= 0;
+}
+
+std::size_t ThreadScalingBenchmark::get_thread_count() const
+{
+    return is_running() ? m_thread_counts[m_run] : 0;
+}
+
+void ThreadScalingBenchmark::record(const double milliseconds)
+{
+    if (!is_running())
+    {
+        return;
+    }
+
+    if (m_frame++ >= WARMUP_FRAMES)
+    {
+        m_sum += milliseconds;
+    }
+    if (m_frame < WARMUP_FRAMES + MEASURED_FRAMES)
+    {
+        return;
+    }
+
+    const auto average = m_sum / MEASURED_FRAMES;
+    const auto single_thread = m_results.empty() ? average : m_results.front().milliseconds;
+    const Result result{
+        .threads = m_thread_counts[m_run],
+        .milliseconds = average,
+        .speedup = average > 0.0 ? single_thread / average : 0.0,
+    };
+    spdlog::info(
+        "thread scaling benchmark, {} threads: {:.3f} ms per frame, {:.2f}x",
+        result.threads,
+        result.milliseconds,
+        result.speedup
+    );
+    m_results.push_back(result);
+
+    m_frame = 0;
+    m_sum = 0.0;
+    if (++m_run == static_cast<int>(m_thread_counts.size()))
+    {
+        m_run = -1;
+    }
+}
+
+const std::vector<ThreadScalingBenchmark::Result> &ThreadScalingBenchmark::get_results() const
+{
+    return m_results;
+}
@@ -0,0 +1,48 @@
+#ifndef THREAD_SCALING_BENCHMARK_H
+#define THREAD_SCALING_BENCHMARK_H
+
+#include <cstddef>
+#include <vector>
+
+// Measures how the CPU work of a frame that runs on the job system scales with the number of
+// threads, by limiting the job system to 1, 2, 4, ... and finally all threads for a fixed number
+// of frames each. The frames of the benchmark redo all of that work every time, see App::render.
+class ThreadScalingBenchmark
+{
+  public:
+    static constexpr int WARMUP_FRAMES = 10;
+    static constexpr int MEASURED_FRAMES = 60;
+
+    struct Result
+    {
+        std::size_t threads{};
+        // Average per frame.
+        double milliseconds{};
+        // Relative to a single thread.
+        double speedup{};
+    };
+
+  private:
+    std::vector<std::size_t> m_thread_counts;
+    // Index into m_thread_counts, -1 while not running.
+    int m_run{-1};
+    int m_frame{};
+    double m_sum{};
+    std::vector<Result> m_results;
+
+  public:
+    explicit ThreadScalingBenchmark() = default;
+    ThreadScalingBenchmark(const ThreadScalingBenchmark &) = delete;
+    const ThreadScalingBenchmark &operator=(const ThreadScalingBenchmark &) = delete;
+
+    void start(std::size_t max_threads);
+    [[nodiscard]] bool is_running() const;
+    // The number of threads to use in the current run.
+    [[nodiscard]] std::size_t get_thread_count() const;
+    // Records the CPU time of a frame and advances to the next run when enough were taken.
+    void record(double milliseconds);
+
+    [[nodiscard]] const std::vector<Result> &get_results() const;
+};
+
+#endif // THREAD_SCALING_BENCHMARK_H
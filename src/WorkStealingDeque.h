@@ -0,0 +1,96 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// A Chase-Lev deque with a fixed capacity: the thread that owns it pushes and pops at the bottom,
+// like a stack, while other threads steal from the top. Only stealing and popping the last item
+// synchronize with a compare-and-swap. `T` has to be lock-free atomic, e.g. a pointer.
+//
+// The memory orderings follow "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et
+// al., 2013). The array never grows, `push` fails when it is full.
+template <typename T, std::size_t CAPACITY> class WorkStealingDeque
+{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+    static constexpr std::int64_t MASK = static_cast<std::int64_t>(CAPACITY) - 1;
+
+    // The owner and the thieves update different ends, so they get a cache line each.
+    alignas(64) std::atomic<std::int64_t> m_top{0};
+    alignas(64) std::atomic<std::int64_t> m_bottom{0};
+    alignas(64) std::array<std::atomic<T>, CAPACITY> m_items{};
+
+  public:
+    explicit WorkStealingDeque() = default;
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    const WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    // Only called by the owner.
+    bool push(const T item)
+    {
+        const auto bottom = m_bottom.load(std::memory_order_relaxed);
+        const auto top = m_top.load(std::memory_order_acquire);
+        if (bottom - top > MASK)
+        {
+            return false;
+        }
+        m_items[bottom & MASK].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Only called by the owner. Takes the most recently pushed item.
+    bool pop(T &item)
+    {
+        const auto bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = m_top.load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = m_items[bottom & MASK].load(std::memory_order_relaxed);
+        if (top < bottom)
+        {
+            return true;
+        }
+        // The last item, which a thief might be taking at the same time.
+        const auto won = m_top.compare_exchange_strong(
+            top,
+            top + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed
+        );
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    // Called by any thread. Takes the least recently pushed item.
+    bool steal(T &item)
+    {
+        auto top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+            return false;
+        }
+
+        item = m_items[top & MASK].load(std::memory_order_relaxed);
+        return m_top.compare_exchange_strong(
+            top,
+            top + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed
+        );
+    }
+};
+
+#endif // WORK_STEALING_DEQUE_H
@@ -1,11 +1,117 @@
 #include "App.h"
 
+#include <charconv>
+#include <string_view>
+
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
 #include <spdlog/spdlog.h>
 
-int main()
+#include "AllocationTracker.h"
+#include "GLObjectRegistry.h"
+#include "ShaderProgram.h"
+
+namespace
+{
+// Parses a count, or two counts of at least 1 separated by 'x' into `second`, such as "16x16".
+bool parse_count(const std::string_view text, int &first, int *second = nullptr)
+{
+    const auto *end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, first);
+    if (result.ec != std::errc() || first < (second ? 1 : 0))
+    {
+        return false;
+    }
+    if (second)
+    {
+        if (result.ptr == end || *result.ptr != 'x')
+        {
+            return false;
+        }
+        result = std::from_chars(result.ptr + 1, end, *second);
+        if (result.ec != std::errc() || *second < 1)
+        {
+            return false;
+        }
+    }
+    return result.ptr == end;
+}
+} // namespace
+
+int main(const int argc, char **argv)
 {
+    // Packed vertices are used unless the full format is requested, e.g. to compare the images.
+    auto vertex_format = SceneGeometry::VertexFormat::Packed;
+    // --grid <columns>x<rows>   instances of the model on a grid, 16x16 with --benchmark
+    // --lights <count>          point lights at random positions
+    // --randomize               random offsets, rotations and scales of the instances
+    // --seed <number>           seed of the random positions, transforms and colors
+    // --benchmark               run the scaling benchmark and exit
+    // --no-allocations          fail once a frame allocates after settling, needs a build with
+    //                           SPONZA_TRACK_ALLOCATIONS
+    App::StressScene stress_scene;
+    auto grid = false;
+    for (auto i = 1; i < argc; ++i)
+    {
+        const auto argument = std::string_view(argv[i]);
+        const auto value = i + 1 < argc ? std::string_view(argv[i + 1]) : std::string_view();
+        auto valid = true;
+        if (argument == "--full-vertices")
+        {
+            vertex_format = SceneGeometry::VertexFormat::Full;
+        }
+        else if (argument == "--grid")
+        {
+            valid = parse_count(value, stress_scene.columns, &stress_scene.rows);
+            grid = true;
+            ++i;
+        }
+        else if (argument == "--lights")
+        {
+            valid = parse_count(value, stress_scene.point_lights);
+            ++i;
+        }
+        else if (argument == "--seed")
+        {
+            auto seed = 0;
+            valid = parse_count(value, seed);
+            stress_scene.seed = static_cast<std::uint32_t>(seed);
+            ++i;
+        }
+        else if (argument == "--randomize")
+        {
+            stress_scene.randomize = true;
+        }
+        else if (argument == "--benchmark")
+        {
+            stress_scene.benchmark = true;
+        }
+        else if (argument == "--no-allocations")
+        {
+            if (!AllocationTracker::is_enabled())
+            {
+                spdlog::error("--no-allocations needs a build with SPONZA_TRACK_ALLOCATIONS.");
+                return EXIT_FAILURE;
+            }
+            AllocationTracker::get().set_steady_state_check(true);
+        }
+        else
+        {
+            spdlog::error("Unknown argument '{}'.", argument);
+            return EXIT_FAILURE;
+        }
+        if (!valid)
+        {
+            spdlog::error("Invalid value '{}' for {}.", value, argument);
+            return EXIT_FAILURE;
+        }
+    }
+    if (stress_scene.benchmark && !grid)
+    {
+        stress_scene.columns = 16;
+        stress_scene.rows = 16;
+    }
+
     glfwInit();
     glfwSetErrorCallback(App::glfw_error_callback);
 
@@ -17,6 +123,18 @@ int main()
     auto *window =
         glfwCreateWindow(App::WINDOW_WIDTH, App::WINDOW_HEIGHT, "Learn OpenGL", nullptr, nullptr);
     if (!window)
+    {
+        // Software drivers such as llvmpipe may only expose OpenGL 4.5.
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+        window = glfwCreateWindow(
+            App::WINDOW_WIDTH,
+            App::WINDOW_HEIGHT,
+            "Learn OpenGL",
+            nullptr,
+            nullptr
+        );
+    }
+    if (!window)
     {
         spdlog::error("Failed to create GLFW window.");
         glfwTerminate();
@@ -32,6 +150,40 @@ int main()
         return EXIT_FAILURE;
     }
 
-    App app(window);
-    return app.run();
+    if (!glMultiDrawElementsIndirectCount &&
+        glfwExtensionSupported("GL_ARB_indirect_parameters"))
+    {
+        glad_glMultiDrawElementsIndirectCount = reinterpret_cast<
+            PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC>(
+            glfwGetProcAddress("glMultiDrawElementsIndirectCountARB")
+        );
+    }
+
+    const char *max_threads = nullptr;
+    if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+    {
+        max_threads = "glMaxShaderCompilerThreadsKHR";
+    }
+    else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+    {
+        max_threads = "glMaxShaderCompilerThreadsARB";
+    }
+    if (max_threads)
+    {
+        ShaderProgram::enable_parallel_compile(
+            reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(glfwGetProcAddress(max_threads))
+        );
+    }
+
+    auto result = EXIT_SUCCESS;
+    {
+        App app(window, vertex_format, stress_scene);
+        result = app.run();
+    }
+    // The app owns every GL object, so anything still alive once it is gone has leaked. The
+    // context is only destroyed afterwards, so that the app's objects can still be deleted.
+    GLObjectRegistry::get().report_leaks();
+
+    glfwTerminate();
+    return result;
 }